@@ -51,6 +51,12 @@ def create_arg_parser() -> argparse.ArgumentParser:
         action = "store_true",
         help = "Build with coverage information")
 
+    # Build with AVX2 instructions
+    parser.add_argument(
+        "--avx2",
+        action = "store_true",
+        help = "Build with AVX2 instructions")
+
     # Build example projects
     parser.add_argument(
         "--examples",
@@ -149,6 +155,9 @@ try:
         if args.coverage:
             cmake_args.append("-DBUILD_WITH_COVERAGE=ON")
 
+        if args.avx2:
+            cmake_args.append("-DBUILD_WITH_AVX2=ON")
+
         if args.examples:
             cmake_args.append("-DBUILD_EXAMPLES=ON")
 
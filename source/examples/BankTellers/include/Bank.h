@@ -52,10 +52,9 @@ public:
 
 private:
   void handleOriginateCustomer(des::SimEngine& sim, const des::Event& evt);
-  void handleTransactionFinish(des::SimEngine& sim, const des::Event& evt);
+  void handleTransactionFinish(des::SimEngine& sim, Teller& teller, const des::Event& evt);
 
   Teller* getAvailableTeller();
-  Teller* getTellerById(int tellerId);
   void startTransaction(des::SimEngine& sim, const des::Event& evt);
 
   void log(const des::Event& evt, const std::string& message);
@@ -64,6 +63,8 @@ private:
   des::SimTime getTransactionTime() const;
 
 private:
+  friend class Teller;
+
   std::vector<Teller> _tellers;
   std::queue<Customer*> _customerQueue;
 
@@ -3,15 +3,21 @@
 
 #include "DESCommon.h"
 #include "core/Event.h"
+#include "core/EventHandler.h"
 
+class Bank;
 class Customer;
 
-class Teller
+class Teller : public des::EventHandler
 {
 public:
-  Teller();
+  explicit Teller(Bank* pBank);
   ~Teller();
 
+  void handleEvent(des::SimEngine& sim, const des::Event& evt) override;
+  void initialize(des::SimEngine& sim) override;
+  void finalize(des::SimEngine& sim) override;
+
   void beginTransaction(des::Event evt, Customer* pCustomer);
   void endTransaction(des::Event evt);
 
@@ -36,6 +42,7 @@ public:
 private:
   static int _nextTellerId;
 
+  Bank* _bank;
   Customer* _activeCustomer;
 
   int _tellerId;
@@ -49,12 +49,11 @@ int main(int argc, char* argv[])
     des::JsonEventWriter eventWriter{file};
     std::cout << "Writing events to " << eventFileName << std::endl;
 
-    // Step simulation while events are available and stop time has not been reached
-    while((sim.hasNextEvent()) && (sim.time() <= stopTime))
+    // Run simulation until the stop time, logging each processed event
+    sim.runUntil(stopTime, [&eventWriter] (des::SimEngine& sim, const des::Event& evt)
     {
-      des::Event evt = sim.step();
       eventWriter.write(evt);
-    }
+    });
 
     file.close();
   }
@@ -13,13 +13,19 @@ Bank::Bank(des::SimEngine& sim, const BankParameters& params)
   _params = params;
 
   // Initialize tellers
+  _tellers.reserve(_params.numTellers);
   for(int i = 0; i < _params.numTellers; ++i)
   {
-    _tellers.push_back(Teller{});
+    _tellers.push_back(Teller{this});
   }
 
-  // Subscribe to all simulation events
-  sim.subscribe(this);
+  // Subscribe to bank events, and each teller to the transaction finish events tagged with its ID
+  sim.subscribe(this, Bank::EVT_START_SIM);
+  sim.subscribe(this, Bank::EVT_ORIGINATE_CUSTOMER);
+  for(auto& teller : _tellers)
+  {
+    sim.subscribe(&teller, Bank::EVT_TRANSACTION_FINISH, teller.id());
+  }
 
   // Seed random number generator
   _rng.seed(std::time(nullptr));
@@ -61,21 +67,6 @@ Teller* Bank::getAvailableTeller()
   return nullptr;
 }
 
-Teller* Bank::getTellerById(int tellerId)
-{
-  // Linear search for teller ID
-  for(auto& it : _tellers)
-  {
-    if(it.id() == tellerId)
-    {
-      return &(it);
-    }
-  }
-
-  // Teller ID not found
-  return nullptr;
-}
-
 void Bank::startTransaction(des::SimEngine& sim, const des::Event& evt)
 {
   // Get customer at front of line
@@ -139,14 +130,10 @@ void Bank::handleOriginateCustomer(des::SimEngine& sim, const des::Event& evt)
   log(evt, sstr.str());
 }
 
-void Bank::handleTransactionFinish(des::SimEngine& sim, const des::Event& evt)
+void Bank::handleTransactionFinish(des::SimEngine& sim, Teller& teller, const des::Event& evt)
 {
-  // Get teller who originated this event
-  Teller* pTeller = getTellerById(evt.tag());
-  if(!pTeller)
-  {
-    throw std::runtime_error("Transaction finish occurred with invalid teller ID");
-  }
+  // Event was routed to the teller who originated it
+  Teller* pTeller = &teller;
 
   // Get teller customer
   Customer* pCustomer = pTeller->activeCustomer();
@@ -233,10 +220,6 @@ void Bank::handleEvent(des::SimEngine& sim, const des::Event& evt)
       handleOriginateCustomer(sim, evt);
       break;
 
-    case Bank::EVT_TRANSACTION_FINISH:
-      handleTransactionFinish(sim, evt);
-      break;
-
     default:
       break;
   }
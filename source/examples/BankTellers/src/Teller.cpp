@@ -3,13 +3,15 @@
 #include "DESCommon.h"
 #include "core/Event.h"
 
+#include "Bank.h"
 #include "Customer.h"
 
 #include <stdexcept>
 
 int Teller::_nextTellerId = 0;
 
-Teller::Teller() :
+Teller::Teller(Bank* pBank) :
+  _bank{pBank},
   _activeCustomer{nullptr},
   _tellerId{_nextTellerId++},
   _transactionStartTime{0},
@@ -46,3 +48,17 @@ void Teller::endTransaction(des::Event evt)
   _activeTime += evt.time() - _transactionStartTime;
   _totalTime += evt.time() - _transactionStartTime;
 }
+
+void Teller::handleEvent(des::SimEngine& sim, const des::Event& evt)
+{
+  // Only transaction finish events tagged with this teller's ID are routed here
+  _bank->handleTransactionFinish(sim, *this, evt);
+}
+
+void Teller::initialize(des::SimEngine& sim)
+{
+}
+
+void Teller::finalize(des::SimEngine& sim)
+{
+}
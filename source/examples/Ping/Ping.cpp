@@ -3,6 +3,9 @@
 #include <map>
 #include <stdexcept>
 
+const des::EventType Ping::PingType;
+const des::EventType Ping::PongType;
+
 static const std::map<des::EventType, std::string> eventNames
 {
   {Ping::PingType, "Ping"},
@@ -34,6 +34,10 @@ int main(int argc, char* argv[])
     // Subscribe Thing One to all events, Thing Two to Pong event only
     sim.subscribe(&thingOne);
     sim.subscribe(&thingTwo, Ping::PongType);
+
+    // Pong is always scheduled 1 after Ping, and Ping 2 after Pong
+    sim.addEventLane(Ping::PongType, 1);
+    sim.addEventLane(Ping::PingType, 2);
     
     // Set up simulation
     sim.initialize();
@@ -44,12 +48,11 @@ int main(int argc, char* argv[])
     // Run simulation
     std::cout << "Running simulation..." << std::endl;
     std::cout << std::endl;
-    while((sim.hasNextEvent()) && (sim.time() <= stopTime))
+    sim.runUntil(stopTime, [] (des::SimEngine& sim, const des::Event& evt)
     {
-      des::Event evt = sim.step();
       std::cout << "*** Processed event type " << evt.type() << " at time " << evt.time() << std::endl;
       std::cout << std::endl;
-    }
+    });
 
     // Finalize
     sim.finalize();
@@ -10,10 +10,14 @@ namespace des
 * @{
 */
 
-typedef uint64_t SimTime;     ///< Simulation time typedef
+typedef uint64_t SimTime;         ///< Simulation time typedef
 
-typedef uint32_t EventType;   ///< Event type typedef
-typedef uint32_t EventTag;    ///< Event tag typedef
+typedef uint32_t EventType;       ///< Event type typedef
+typedef uint32_t EventTag;        ///< Event tag typedef
+typedef uint16_t EventPriority;   ///< Event priority typedef
+
+typedef int32_t HandlerPriority;  ///< Event handler dispatch priority typedef
+typedef uint32_t HandlerId;       ///< Event handler address typedef
 
 /** @} */
 } // End namespace
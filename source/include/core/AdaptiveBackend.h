@@ -0,0 +1,96 @@
+#ifndef __DES_ADAPTIVEBACKEND_H__
+#define __DES_ADAPTIVEBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include <memory>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend that switches data structure as the workload changes
+ *
+ *  Events are held in a sorted array while there are few of them, in a 4-ary heap
+ *  by default, and in a calendar queue when there are many events and the time
+ *  increments between removed events are regular enough for fixed-width buckets.
+ *  The increments are sampled on every removal, and every SampleInterval removals
+ *  the structure best suited to the current event count and increment statistics
+ *  is selected.  Events are migrated together with their keys, so the order of
+ *  events with equal times is preserved.  A sorted array that outgrows its limit is migrated
+ *  to a heap immediately on insert.  Limits apply with a factor of two hysteresis
+ *  so the structure does not flip back and forth around a limit.
+ */
+class AdaptiveBackend : public QueueBackend
+{
+public:
+  /** @brief  Data structures used to hold events */
+  enum class Structure
+  {
+    SortedArray,    ///< Sorted array, for few events
+    Heap,           ///< 4-ary heap
+    Buckets         ///< Calendar queue, for many events with regular time increments
+  };
+
+  AdaptiveBackend();
+  ~AdaptiveBackend();
+
+  using QueueBackend::insert;
+  void insert(const Event& e, const EventKey& key) override;
+  void appendUnordered(const Event& e, const EventKey& key) override;
+  void restoreOrder(const size_t appended) override;
+  void reserve(const size_t count) override;
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _backend->size(); }
+
+  /** @return  Data structure currently holding the events */
+  inline Structure structure() const noexcept
+  { return _structure; }
+
+  static constexpr size_t SmallLimit = 32;          ///< Event count up to which the sorted array is used
+  static constexpr size_t BucketLimit = 8192;       ///< Event count from which the calendar queue may be used
+  static constexpr size_t SampleInterval = 1024;    ///< Number of removals between structure selections
+  static constexpr double MaxVariation = 2.0;       ///< Largest ratio of increment deviation to mean increment suited to buckets
+
+private:
+  /**
+   * @brief  Create an empty backend for a data structure
+   * @param structure  Data structure
+   * @return  New backend
+   */
+  static std::unique_ptr<QueueBackend> CreateBackend(const Structure structure);
+
+  /** @return  Data structure best suited to the current event count and sampled increments */
+  Structure select() const noexcept;
+
+  /**
+   * @brief  Move all events to a new data structure
+   * @param structure  Data structure to move events to
+   */
+  void migrate(const Structure structure);
+
+  /** @brief  Migrate a sorted array that has outgrown its limit */
+  void checkGrowth();
+
+  std::unique_ptr<QueueBackend> _backend;   ///< Backend holding the events
+  Structure _structure;                     ///< Data structure of the backend
+
+  SimTime _lastTime;      ///< Time of the last removed event
+  size_t _samples;        ///< Number of increments sampled since the last selection
+  double _sum;            ///< Sum of sampled increments
+  double _sumSquares;     ///< Sum of squared sampled increments
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef __DES_ALIGNEDALLOCATOR_H__
+#define __DES_ALIGNEDALLOCATOR_H__
+
+#include "DESCommon.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Allocator returning memory aligned to a given boundary
+ *
+ *  Used to start containers on a cache line boundary
+ *
+ * @tparam T  Allocated type
+ * @tparam Alignment  Alignment in bytes, must be a power of two
+ */
+template<typename T, size_t Alignment>
+class AlignedAllocator
+{
+  static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+  static_assert(Alignment >= alignof(void*), "Alignment must be at least pointer alignment");
+
+public:
+  typedef T value_type;   ///< Allocated type
+
+  /** @brief  Allocator for another type with the same alignment */
+  template<typename U>
+  struct rebind
+  {
+    typedef AlignedAllocator<U, Alignment> other;   ///< Rebound allocator type
+  };
+
+  AlignedAllocator() noexcept
+  {}
+
+  /** @brief  Construct from an allocator for another type */
+  template<typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+  {}
+
+  /**
+   * @brief  Allocate aligned storage
+   * @param n  Number of objects to allocate storage for
+   * @return  Pointer to aligned storage
+   * @throws std::bad_alloc if allocation fails
+   */
+  T* allocate(const size_t n)
+  {
+    if(n > (std::numeric_limits<size_t>::max() - Alignment - sizeof(void*)) / sizeof(T))
+    {
+      throw std::bad_alloc{};
+    }
+
+    // Over-allocate and store the original pointer just ahead of the aligned block
+    void* raw = ::operator new((n * sizeof(T)) + Alignment + sizeof(void*));
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + Alignment - 1) & ~(uintptr_t)(Alignment - 1);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+
+    return reinterpret_cast<T*>(aligned);
+  }
+
+  /**
+   * @brief  Release storage returned by allocate
+   * @param p  Pointer to storage
+   */
+  void deallocate(T* p, const size_t) noexcept
+  { ::operator delete(reinterpret_cast<void**>(p)[-1]); }
+};
+
+template<typename T, typename U, size_t Alignment>
+inline bool operator == (const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept
+{ return true; }
+
+template<typename T, typename U, size_t Alignment>
+inline bool operator != (const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept
+{ return false; }
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef __DES_BACKENDQUEUE_H__
+#define __DES_BACKENDQUEUE_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include <cstdint>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Priority queue of events holding a backend of a type known at compile time
+ *
+ *  Calls into the backend are qualified with the backend type, so they are bound
+ *  statically rather than through the QueueBackend vtable.  Events are keyed as in
+ *  EventQueue, breaking ties by priority, then insertion order.  Lanes, indices and
+ *  handles are left to EventQueue.
+ *
+ * @tparam Backend  Backend type, a concrete QueueBackend
+ */
+template<typename Backend>
+class BackendQueue
+{
+public:
+  BackendQueue() :
+    _backend{},
+    _sequence{0}
+  {}
+
+  /**
+   * @brief  Insert an event into the queue
+   * @param e  Event to insert
+   */
+  inline void insert(const Event& e)
+  { _backend.Backend::insert(e, EventKey::Make(e, EventKey::Next(_sequence))); }
+
+  /**
+   * @brief  Insert an event with the given parameters into the queue
+   *
+   * @param evtTime  Event time
+   * @param evtType  Event type
+   * @param evtTag  Event tag
+   * @param evtPriority  Event priority
+   */
+  inline void insert(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0,
+    const EventPriority evtPriority = 0)
+  { insert(Event{evtTime, evtType, evtTag, evtPriority}); }
+
+  /**
+   * @brief  Reserve storage for events
+   * @param count  Number of events to reserve storage for
+   */
+  inline void reserve(const size_t count)
+  { _backend.Backend::reserve(count); }
+
+  /**
+   * @brief  Remove the earliest event from the queue, the queue must not be empty
+   * @return  Earliest event
+   */
+  inline Event getNext()
+  { return _backend.Backend::getNext(); }
+
+  /** @return  Earliest event in the queue, the queue must not be empty */
+  inline const Event& peekNext() const
+  { return _backend.Backend::peekNext(); }
+
+  /** @return  Number of events in the queue */
+  inline size_t size() const noexcept
+  { return _backend.Backend::size(); }
+
+  /** @return  True if queue is empty */
+  inline bool empty() const noexcept
+  { return (size() == 0); }
+
+  /** @return  Backend holding the events */
+  inline const Backend& backend() const noexcept
+  { return _backend; }
+
+private:
+  Backend _backend;     ///< Backend holding the events
+  uint64_t _sequence;   ///< Insertion sequence of the next event
+};
+
+/** @} */
+} // End namespace
+
+#endif
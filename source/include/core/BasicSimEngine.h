@@ -0,0 +1,356 @@
+#ifndef __DES_BASICSIMENGINE_H__
+#define __DES_BASICSIMENGINE_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "SimEngine.h"
+#include <stdexcept>
+#include <utility>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Simulation engine with its schedule and dispatch chosen at compile time
+ *
+ *  Behaves as SimEngine, with the same states and errors, but the schedule and the
+ *  handler dispatch are template policies, so the event loop makes no virtual
+ *  calls when the policies don't.  BackendQueue with a concrete backend and
+ *  StaticDispatch with the handler types give a fully static loop, while
+ *  EventQueue can be used as the schedule for lanes, indices or a backend chosen
+ *  at run time.
+ *
+ *  The schedule policy provides insert, getNext, peekNext, empty, size and reserve
+ *  as EventQueue does.  Events are not addressed to single handlers, so events
+ *  carrying a target are rejected.  The dispatch policy provides subscribe, and initialize,
+ *  finalize and dispatch taking the engine.
+ *
+ * @tparam QueuePolicy  Type of the event schedule
+ * @tparam DispatchPolicy  Type passing events to the subscribed handlers
+ */
+template<typename QueuePolicy, typename DispatchPolicy>
+class BasicSimEngine
+{
+public:
+  BasicSimEngine() :
+    _time{0},
+    _state{SimEngineState::Uninitialized},
+    _schedule{},
+    _dispatch{}
+  {}
+
+  BasicSimEngine(const BasicSimEngine&) = delete;
+  BasicSimEngine& operator = (const BasicSimEngine&) = delete;
+
+  /**
+   * @brief  Subscribe an event handler to all events
+   * @param handler  Handler to subscribe
+   * @throws std::runtime_error if simulation is not in the Uninitialized state
+   * @throws std::invalid_argument if handler is null
+   */
+  template<typename Handler>
+  void subscribe(Handler* handler)
+  {
+    checkUninitialized();
+    _dispatch.subscribe(handler);
+  }
+
+  /**
+   * @brief  Subscribe an event handler to a specific event type
+   * @param handler  Handler to subscribe
+   * @param evtType  Event type to subscribe to
+   * @throws std::runtime_error if simulation is not in the Uninitialized state
+   * @throws std::invalid_argument if handler is null
+   */
+  template<typename Handler>
+  void subscribe(Handler* handler, const EventType evtType)
+  {
+    checkUninitialized();
+    _dispatch.subscribe(handler, evtType);
+  }
+
+  /**
+   * @brief  Initialize the simulation
+   *
+   * Calls initialize on all subscribed event handlers
+   * Simulation will be in the Running state after calling initialize
+   *
+   * @throws std::runtime_error if simulation is not in the Uninitialized state
+   */
+  void initialize()
+  {
+    checkUninitialized();
+
+    try
+    {
+      _dispatch.initialize(*this);
+      _state = SimEngineState::Running;
+    }
+    catch(...)
+    {
+      _state = SimEngineState::Error;
+      throw;
+    }
+  }
+
+  /**
+   * @brief  Advance the simulation one step
+   *
+   * @return Event processed on the step
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws std::runtime_error if the schedule is empty
+   * @throws CausalityException if the event being processed occurs before the current simulation time
+   */
+  Event step()
+  {
+    checkRunning();
+
+    if(_schedule.empty())
+    {
+      throw std::runtime_error("Schedule is empty");
+    }
+
+    Event evt{0, 0};
+    runLoop([] (size_t processed) { return (processed > 0); },
+      [&evt] (BasicSimEngine&, const Event& processed) { evt = processed; });
+
+    return evt;
+  }
+
+  /**
+   * @brief  Process events until the schedule is empty
+   *
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  inline size_t run()
+  { return run(NoObserver{}); }
+
+  /**
+   * @brief  Process events until the schedule is empty, calling an observer after each event
+   *
+   * @param observer  Called with the engine and each event after it has been passed to all handlers
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  template<typename Observer>
+  size_t run(Observer observer)
+  { return runLoop([] (size_t) { return false; }, observer); }
+
+  /**
+   * @brief  Process all events occurring at or before a stop time
+   *
+   * @param stopTime  Time of the last events to process
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  inline size_t runUntil(const SimTime stopTime)
+  { return runUntil(stopTime, NoObserver{}); }
+
+  /**
+   * @brief  Process all events occurring at or before a stop time, calling an observer after each event
+   *
+   * @param stopTime  Time of the last events to process
+   * @param observer  Called with the engine and each event after it has been passed to all handlers
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  template<typename Observer>
+  size_t runUntil(const SimTime stopTime, Observer observer)
+  { return runLoop([this, stopTime] (size_t) { return (_schedule.peekNext().time() > stopTime); }, observer); }
+
+  /**
+   * @brief  Process up to a number of events, stopping early if the schedule empties
+   *
+   * @param count  Maximum number of events to process
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  inline size_t runFor(const size_t count)
+  { return runFor(count, NoObserver{}); }
+
+  /**
+   * @brief  Process up to a number of events, calling an observer after each event
+   *
+   * @param count  Maximum number of events to process
+   * @param observer  Called with the engine and each event after it has been passed to all handlers
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  template<typename Observer>
+  size_t runFor(const size_t count, Observer observer)
+  { return runLoop([count] (size_t processed) { return (processed >= count); }, observer); }
+
+  /**
+   * @brief  Finalize the simulation
+   *
+   * Simulation will be in the Finalized state after calling finalize
+   *
+   * @throws std::runtime_error if simulation is not in the Running state
+   */
+  void finalize()
+  {
+    checkRunning();
+
+    try
+    {
+      _dispatch.finalize(*this);
+      _state = SimEngineState::Finalized;
+    }
+    catch(...)
+    {
+      _state = SimEngineState::Error;
+      throw;
+    }
+  }
+
+  /**
+   * @brief  Insert an event into the simulation schedule
+   *
+   * Events addressed to a handler are rejected, as the dispatch policies pass
+   * events to the handlers subscribed to their type and have no registered targets
+   *
+   * @param evt  Event to insert
+   * @throws std::logic_error if the event is addressed to a handler
+   */
+  inline void insertEvent(const Event& evt)
+  {
+    if(evt.target() != Event::NoTarget)
+    {
+      throw std::logic_error("Addressed events are not supported");
+    }
+
+    _schedule.insert(evt);
+  }
+
+  /**
+   * @brief  Insert an event with the given parameters into the simulation schedule
+   *
+   * @param evtTime  Event time
+   * @param evtType  Event type
+   * @param evtTag  Event tag
+   * @param evtPriority  Event priority
+   */
+  inline void insertEvent(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0,
+    const EventPriority evtPriority = 0)
+  { _schedule.insert(evtTime, evtType, evtTag, evtPriority); }
+
+  /**
+   * @brief  Reserve storage in the simulation schedule
+   * @param count  Number of events to reserve storage for
+   */
+  inline void reserveEvents(const size_t count)
+  { _schedule.reserve(count); }
+
+  /** @return True if simulation has an event in the schedule, false otherwise */
+  inline bool hasNextEvent() const noexcept
+  { return !_schedule.empty(); }
+
+  /** @return Number of events in the schedule */
+  inline size_t eventCount() const noexcept
+  { return _schedule.size(); }
+
+  /** @return Simulation time of most recently processed event */
+  inline SimTime time() const noexcept
+  { return _time; }
+
+  /** @return Simulation state */
+  inline SimEngineState state() const noexcept
+  { return _state; }
+
+  /** @return Simulation event schedule */
+  inline QueuePolicy& schedule() noexcept
+  { return _schedule; }
+
+  /** @return Simulation event schedule */
+  inline const QueuePolicy& schedule() const noexcept
+  { return _schedule; }
+
+private:
+  /** @brief  Observer of a run loop without one */
+  struct NoObserver
+  {
+    inline void operator () (BasicSimEngine&, const Event&) const noexcept
+    {}
+  };
+
+  /** @throws std::runtime_error if simulation is not in the Uninitialized state */
+  inline void checkUninitialized() const
+  {
+    if(_state != SimEngineState::Uninitialized)
+    {
+      throw std::runtime_error("Simulation is not Uninitialized");
+    }
+  }
+
+  /** @throws std::runtime_error if simulation is not in the Running state */
+  inline void checkRunning() const
+  {
+    if(_state != SimEngineState::Running)
+    {
+      throw std::runtime_error("Simulation is not Running");
+    }
+  }
+
+  /**
+   * @brief  Process events until the schedule is empty or a stop condition is met
+   * @param stop  Called with the number of events processed before each event, returns true to stop
+   * @param observe  Called with each event after dispatch
+   * @return Number of events processed
+   */
+  template<typename Stop, typename Observe>
+  size_t runLoop(Stop stop, Observe observe)
+  {
+    checkRunning();
+
+    size_t processed = 0;
+    try
+    {
+      while(!_schedule.empty() && !stop(processed))
+      {
+        Event evt = _schedule.getNext();
+
+        if(evt.time() < _time)
+        {
+          throw CausalityException(evt, "Event violates causality");
+        }
+
+        _time = evt.time();
+        _dispatch.dispatch(*this, evt);
+        observe(*this, evt);
+        ++processed;
+      }
+    }
+    catch(const CausalityException&)
+    {
+      throw;
+    }
+    catch(...)
+    {
+      _state = SimEngineState::Error;
+      throw;
+    }
+
+    return processed;
+  }
+
+  SimTime _time;              ///< Simulation time of most recently processed event
+  SimEngineState _state;      ///< Simulation state
+
+  QueuePolicy _schedule;      ///< Simulation event schedule
+  DispatchPolicy _dispatch;   ///< Passes events to the subscribed handlers
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef __DES_BINARYHEAPBACKEND_H__
+#define __DES_BINARYHEAPBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include <vector>
+#include <cstdint>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend storing events in an indexed binary heap
+ *
+ *  The heap holds only packed sort keys, with the slot holding each event in a
+ *  parallel array, so sifting compares keys in a dense array and moves 20 bytes
+ *  per node rather than whole events.  Events stay in their slot until removed.
+ *  Slots also record the heap position of their event, so tracked events can be
+ *  found, cancelled and rescheduled in O(log n).  Event identifiers combine the
+ *  slot with a generation count that changes whenever the slot is released, so
+ *  identifiers of removed events are never mistaken for new events.
+ */
+class BinaryHeapBackend : public QueueBackend
+{
+public:
+  BinaryHeapBackend();
+  ~BinaryHeapBackend();
+
+  using QueueBackend::insert;
+  void insert(const Event& e, const EventKey& key) override;
+  void appendUnordered(const Event& e, const EventKey& key) override;
+  void restoreOrder(const size_t appended) override;
+  void reserve(const size_t count) override;
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _keys.size(); }
+
+  inline bool supportsHandles() const noexcept override
+  { return true; }
+
+  uint64_t insertTracked(const Event& e, const EventKey& key) override;
+  bool cancel(const uint64_t id) override;
+  bool reschedule(const uint64_t id, const SimTime newTime, const uint64_t sequence) override;
+  bool pending(const uint64_t id) const override;
+  bool lookup(const uint64_t id, KeyedEvent& e) const override;
+
+private:
+  static constexpr uint32_t NotQueued = UINT32_MAX;   ///< Position of an event that is not in the heap
+
+  /** @brief  Slot holding an event and tracking its heap position */
+  struct Slot
+  {
+    Event event;            ///< Queued event
+    uint32_t position;      ///< Position of the key in the heap
+    uint32_t generation;    ///< Incremented whenever the slot is released
+  };
+
+  /**
+   * @brief  Add a key to the end of the heap without ordering it
+   * @param e  Event to hold
+   * @param key  Sort key of the event
+   * @return  Slot assigned to the event
+   */
+  uint32_t append(const Event& e, const EventKey& key);
+
+  /**
+   * @brief  Place a key and its slot at a heap position
+   * @param position  Heap position
+   * @param key  Sort key
+   * @param slot  Slot holding the event
+   */
+  inline void assign(const size_t position, const EventKey& key, const uint32_t slot) noexcept
+  {
+    _keys[position] = key;
+    _heapSlots[position] = slot;
+    _slots[slot].position = (uint32_t)position;
+  }
+
+  /**
+   * @brief  Find the heap position of a tracked event
+   * @param id  Identifier of the event
+   * @return  Position of the event, NotQueued if it is no longer held
+   */
+  uint32_t locate(const uint64_t id) const noexcept;
+
+  /**
+   * @brief  Remove the key at a heap position and release its slot
+   * @param position  Position of the key
+   * @return  Event held by the slot
+   */
+  Event removeAt(const size_t position);
+
+  /**
+   * @brief  Move a key towards the root until the heap is ordered
+   * @param position  Position of the key
+   */
+  void siftUp(size_t position);
+
+  /**
+   * @brief  Move a key towards the leaves until the heap is ordered
+   * @param position  Position of the key
+   */
+  void siftDown(size_t position);
+
+  std::vector<EventKey> _keys;          ///< Binary heap of sort keys, earliest key at the root
+  std::vector<uint32_t> _heapSlots;     ///< Slot holding the event of each key, parallel to the heap
+  std::vector<Slot> _slots;             ///< Events and heap positions indexed by slot
+  std::vector<uint32_t> _freeSlots;     ///< Released slots available for reuse
+};
+
+/** @} */
+} // End namespace
+
+#endif
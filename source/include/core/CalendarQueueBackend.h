@@ -0,0 +1,81 @@
+#ifndef __DES_CALENDARQUEUEBACKEND_H__
+#define __DES_CALENDARQUEUEBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include <vector>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend storing events in a calendar queue
+ *
+ *  Events are hashed by time into a ring of buckets ("days") of equal width.
+ *  The number of buckets doubles or halves as the queue grows or shrinks, and the
+ *  bucket width is recalculated from the spacing of the earliest events on each
+ *  resize, giving amortized O(1) insert and removal.
+ */
+class CalendarQueueBackend : public QueueBackend
+{
+public:
+  CalendarQueueBackend();
+  ~CalendarQueueBackend();
+
+  using QueueBackend::insert;
+  void insert(const Event& e, const EventKey& key) override;
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _size; }
+
+  /** @return  Number of buckets in the calendar */
+  inline size_t bucketCount() const noexcept
+  { return _buckets.size(); }
+
+  /** @return  Time span covered by each bucket */
+  inline SimTime bucketWidth() const noexcept
+  { return _width; }
+
+private:
+  static constexpr size_t MinBuckets = 2;     ///< Minimum number of buckets
+  static constexpr size_t SampleSize = 25;    ///< Number of events sampled to calculate bucket width
+
+  /**
+   * @brief  Advance the search position to the bucket holding the next event
+   * @return  Index of the bucket holding the next event
+   */
+  size_t locateNext() const;
+
+  /**
+   * @brief  Rebuild the calendar with a new number of buckets and a new bucket width
+   * @param bucketCount  New number of buckets, must be a power of two
+   */
+  void resize(size_t bucketCount);
+
+  /**
+   * @brief  Insert an event into its bucket without resizing
+   * @param e  Event to insert
+   */
+  void place(const KeyedEvent& e);
+
+  std::vector<std::vector<KeyedEvent>> _buckets;   ///< Buckets, each sorted with the earliest event at the back
+  size_t _mask;             ///< Mask converting a time slot to a bucket index
+  size_t _size;             ///< Number of events held
+  SimTime _width;           ///< Time span covered by each bucket
+
+  mutable size_t _bucket;   ///< Bucket currently being searched
+  mutable SimTime _slot;    ///< Time slot (time divided by width) currently being searched
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef __DES_DARYHEAPBACKEND_H__
+#define __DES_DARYHEAPBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include "AlignedAllocator.h"
+#include <vector>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend storing events in an implicit d-ary heap
+ *
+ *  Event times are kept in a key array separate from the events, laid out so the
+ *  children of every node occupy one aligned group of Arity keys.  For an 8-ary
+ *  heap a group is exactly one 64 byte cache line, so each level of a sift touches
+ *  a single line, and the heap is half as deep as a binary heap.  The minimum child
+ *  is selected with AVX2 comparisons of the times when available, with the rare
+ *  ties between children broken by priority and insertion order, otherwise with an unrolled
+ *  scalar loop over the full keys.  Keys are compared directly rather than
+ *  through a comparator object.
+ *
+ * @tparam Arity  Number of children per node, 4 or 8
+ */
+template<size_t Arity>
+class DaryHeapBackend : public QueueBackend
+{
+  static_assert((Arity == 4) || (Arity == 8), "Arity must be 4 or 8");
+
+public:
+  DaryHeapBackend();
+  ~DaryHeapBackend();
+
+  using QueueBackend::insert;
+  void insert(const Event& e, const EventKey& key) override;
+  void appendUnordered(const Event& e, const EventKey& key) override;
+  void restoreOrder(const size_t appended) override;
+  void reserve(const size_t count) override;
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _size; }
+
+private:
+  static constexpr size_t Root = Arity - 1;     ///< Index of the root node, placed so child groups are aligned
+  static constexpr size_t CacheLine = 64;       ///< Cache line size in bytes
+
+  /**
+   * @param node  Index of a node
+   * @return  Index of the first child of the node
+   */
+  static inline size_t FirstChild(const size_t node) noexcept
+  { return Arity * (node - Arity + 2); }
+
+  /**
+   * @param node  Index of a node other than the root
+   * @return  Index of the parent of the node
+   */
+  static inline size_t Parent(const size_t node) noexcept
+  { return (node / Arity) + Arity - 2; }
+
+  /**
+   * @param node  Index of a node
+   * @return  Sort key of the node
+   */
+  inline EventKey key(const size_t node) const noexcept
+  { return EventKey{_keys[node], _orders[node]}; }
+
+  /**
+   * @brief  Place a key and its event at a node
+   * @param node  Index of the node
+   * @param nodeKey  Sort key
+   * @param e  Event
+   */
+  inline void store(const size_t node, const EventKey& nodeKey, const Event& e) noexcept
+  {
+    _keys[node] = nodeKey.time;
+    _orders[node] = nodeKey.order;
+    _events[node] = e;
+  }
+
+  /** @brief  Ensure storage is available for one more node */
+  void grow();
+
+  /**
+   * @brief  Move a node towards the root until the heap is ordered
+   * @param node  Index of the node
+   */
+  void siftUp(size_t node);
+
+  /**
+   * @brief  Move a node towards the leaves until the heap is ordered
+   * @param node  Index of the node
+   */
+  void siftDown(size_t node);
+
+  /**
+   * @brief  Find the child with the earliest time in a group of children
+   * @param first  Index of the first child in the group, a multiple of Arity
+   * @return  Index of the child with the earliest time
+   */
+  size_t minChild(const size_t first) const noexcept;
+
+  /**
+   * @brief  Select the child with the earliest order word among children with the earliest time, for AVX2 selection
+   * @param first  Index of the first child in the group
+   * @param mask  Bit mask of the children with the earliest time, relative to the first child
+   * @return  Index of the selected child
+   */
+  size_t breakTie(const size_t first, unsigned mask) const noexcept;
+
+  std::vector<SimTime, AlignedAllocator<SimTime, CacheLine>> _keys;   ///< Event times, unused entries hold the maximum time and order
+  std::vector<uint64_t> _orders;                                      ///< Order words of the sort keys, at the same index as their times
+  std::vector<Event> _events;                                         ///< Events, at the same index as their keys
+  size_t _size;                                                       ///< Number of events held
+};
+
+typedef DaryHeapBackend<4> QuaternaryHeapBackend;   ///< 4-ary heap backend
+typedef DaryHeapBackend<8> OctonaryHeapBackend;     ///< 8-ary heap backend
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,346 @@
+#ifndef __DES_DISPATCHTABLE_H__
+#define __DES_DISPATCHTABLE_H__
+
+#include "DESCommon.h"
+#include "EventHandler.h"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Flat table of the handlers to call for each event type, compiled from the subscriptions
+ *
+ *  All handler entries are kept in one contiguous array.  Each subscribed event
+ *  type owns a run of the array holding the global handlers followed by the
+ *  handlers subscribed to the type, so dispatching an event is one lookup and a
+ *  linear walk.  Types below DenseLimit are looked up by index in a dense array,
+ *  larger type values in a hash map, and unsubscribed types share the run of
+ *  global handlers.
+ *
+ *  A single type can be updated without recompiling the table.  Its new run is
+ *  written at the end of the array and the old run is left unused, and the array
+ *  is compacted once more than half of it is unused, which keeps updates O(run
+ *  length) amortized.  Replacing the global handlers rewrites the start of every
+ *  run in one pass over the array.  Any change can reallocate the array, so it
+ *  invalidates the runs returned by find.  The table does not guard against this
+ *  itself, SimEngine relies on queueing subscription changes made during dispatch
+ *  until the handlers of the event have all been called.
+ *
+ * @tparam T  Type of the handler entries, a handler pointer or a tagged handler reference
+ */
+template<typename T>
+class BasicDispatchTable
+{
+public:
+  static constexpr EventType DenseLimit = 1024;   ///< Event types below this are looked up by index
+
+  /** @brief  Contiguous run of handlers */
+  class Handlers
+  {
+  public:
+    Handlers(const T* first, const T* last) noexcept :
+      _first{first},
+      _last{last}
+    {}
+
+    /** @return  Pointer to the first handler */
+    inline const T* begin() const noexcept
+    { return _first; }
+
+    /** @return  Pointer following the last handler */
+    inline const T* end() const noexcept
+    { return _last; }
+
+    /** @return  Number of handlers */
+    inline size_t size() const noexcept
+    { return (_last - _first); }
+
+  private:
+    const T* _first;   ///< First handler
+    const T* _last;    ///< Following the last handler
+  };
+
+  BasicDispatchTable() :
+    _handlers{},
+    _global{0, 0},
+    _dense{},
+    _sparse{},
+    _unused{0}
+  {}
+
+  /**
+   * @brief  Rebuild the table from the subscriptions
+   * @param globalHandlers  Handlers subscribed to all events, in dispatch order
+   * @param typeHandlers  Handlers subscribed to specific event types, in dispatch order
+   */
+  void compile(const std::vector<T>& globalHandlers, const std::map<EventType, std::vector<T>>& typeHandlers)
+  {
+    _handlers.clear();
+    _dense.clear();
+    _sparse.clear();
+    _unused = 0;
+
+    _handlers.insert(_handlers.end(), globalHandlers.cbegin(), globalHandlers.cend());
+    _global = Run{0, (uint32_t)_handlers.size()};
+
+    // Size the dense array to the largest subscribed type below the limit
+    for(const auto& it : typeHandlers)
+    {
+      if((it.first < DenseLimit) && !it.second.empty())
+      {
+        _dense.resize(it.first + 1, _global);
+      }
+    }
+
+    for(const auto& it : typeHandlers)
+    {
+      if(it.second.empty())
+      {
+        continue;
+      }
+
+      const uint32_t first = (uint32_t)_handlers.size();
+      _handlers.insert(_handlers.end(), globalHandlers.cbegin(), globalHandlers.cend());
+      _handlers.insert(_handlers.end(), it.second.cbegin(), it.second.cend());
+      const Run run{first, (uint32_t)_handlers.size()};
+
+      if(it.first < DenseLimit)
+      {
+        _dense[it.first] = run;
+      }
+      else
+      {
+        _sparse[it.first] = run;
+      }
+    }
+  }
+
+  /**
+   * @param type  Event type
+   * @return  Handlers to call for an event of the type, global handlers first
+   */
+  inline Handlers find(const EventType type) const noexcept
+  {
+    if(type < _dense.size())
+    {
+      return handlers(_dense[type]);
+    }
+
+    auto it = _sparse.find(type);
+    return handlers((it != _sparse.cend()) ? it->second : _global);
+  }
+
+  /**
+   * @param type  Event type
+   * @return  True if the handlers of the type are in the table, types below DenseLimit always are
+   */
+  inline bool resolved(const EventType type) const noexcept
+  { return ((type < DenseLimit) || (_sparse.find(type) != _sparse.cend())); }
+
+  /**
+   * @brief  Add the handlers of an event type that was not compiled into the table
+   *
+   * Types without handlers of their own are not stored, find returns the global handlers for them
+   * Handler runs returned by find before the resolve are invalidated
+   *
+   * @param type  Event type, at least DenseLimit
+   * @param typeHandlers  Handlers subscribed to the type, in dispatch order
+   */
+  void resolve(const EventType type, const std::vector<T>& typeHandlers)
+  {
+    if(typeHandlers.empty())
+    {
+      return;
+    }
+
+    // Copy the global handlers first, inserting a range of the array into itself is not allowed
+    const std::vector<T> globalHandlers(_handlers.cbegin() + _global.first, _handlers.cbegin() + _global.last);
+
+    const uint32_t first = (uint32_t)_handlers.size();
+    _handlers.insert(_handlers.end(), globalHandlers.cbegin(), globalHandlers.cend());
+    _handlers.insert(_handlers.end(), typeHandlers.cbegin(), typeHandlers.cend());
+    _sparse[type] = Run{first, (uint32_t)_handlers.size()};
+  }
+
+  /**
+   * @brief  Replace the handlers of one event type, leaving the global handlers and other types unchanged
+   *
+   * Handler runs returned by find before the update are invalidated
+   *
+   * @param type  Event type
+   * @param typeHandlers  Handlers subscribed to the type, in dispatch order
+   */
+  void update(const EventType type, const std::vector<T>& typeHandlers)
+  {
+    Run run = _global;
+    if(!typeHandlers.empty())
+    {
+      // Reserve first so copying the global handlers from the array itself cannot reallocate it,
+      // growing geometrically as appending would
+      const size_t size = _handlers.size() + (_global.last - _global.first) + typeHandlers.size();
+      if(size > _handlers.capacity())
+      {
+        _handlers.reserve(std::max(size, 2 * _handlers.capacity()));
+      }
+
+      run.first = (uint32_t)_handlers.size();
+      for(uint32_t i = _global.first; i < _global.last; ++i)
+      {
+        _handlers.push_back(_handlers[i]);
+      }
+      _handlers.insert(_handlers.end(), typeHandlers.cbegin(), typeHandlers.cend());
+      run.last = (uint32_t)_handlers.size();
+    }
+
+    if(type < DenseLimit)
+    {
+      if(type >= _dense.size())
+      {
+        _dense.resize(type + 1, _global);
+      }
+
+      retire(_dense[type]);
+      _dense[type] = run;
+    }
+    else
+    {
+      auto it = _sparse.find(type);
+      if(it != _sparse.cend())
+      {
+        retire(it->second);
+        _sparse.erase(it);
+      }
+
+      // Large types without handlers of their own fall back to the global handlers
+      if(!typeHandlers.empty())
+      {
+        _sparse[type] = run;
+      }
+    }
+
+    if(_unused > (_handlers.size() / 2))
+    {
+      compact();
+    }
+  }
+
+  /**
+   * @brief  Replace the global handlers, leaving the handlers of each type unchanged
+   *
+   * Every run starts with the global handlers, so the array is rebuilt in one pass
+   * over the runs in use, without looking up the subscriptions of any type.
+   * Handler runs returned by find before the update are invalidated
+   *
+   * @param globalHandlers  Handlers subscribed to all events, in dispatch order
+   */
+  void updateGlobal(const std::vector<T>& globalHandlers)
+  { rebuild(globalHandlers); }
+
+  /** @return  Event types of at least DenseLimit with handlers of their own in the table */
+  std::vector<EventType> sparseTypes() const
+  {
+    std::vector<EventType> types{};
+    types.reserve(_sparse.size());
+    for(const auto& it : _sparse)
+    {
+      types.push_back(it.first);
+    }
+
+    return types;
+  }
+
+private:
+  /** @brief  Position of a run of handlers in the handler array */
+  struct Run
+  {
+    uint32_t first;   ///< Index of the first handler
+    uint32_t last;    ///< Index following the last handler
+
+    inline bool operator == (const Run& rhs) const noexcept
+    { return ((first == rhs.first) && (last == rhs.last)); }
+  };
+
+  /**
+   * @brief  Count a run that is no longer referenced as unused
+   * @param run  Run being replaced
+   */
+  inline void retire(const Run& run) noexcept
+  {
+    if(!(run == _global))
+    {
+      _unused += (run.last - run.first);
+    }
+  }
+
+  /** @brief  Rebuild the handler array from the runs in use */
+  inline void compact()
+  { rebuild(std::vector<T>(_handlers.cbegin() + _global.first, _handlers.cbegin() + _global.last)); }
+
+  /**
+   * @brief  Rebuild the handler array from the runs in use, replacing the global handlers at the start of each run
+   * @param globalHandlers  Handlers subscribed to all events, in dispatch order
+   */
+  void rebuild(const std::vector<T>& globalHandlers)
+  {
+    const uint32_t globalCount = _global.last - _global.first;
+
+    std::vector<T> handlers{};
+    handlers.reserve(_handlers.size() - _unused - globalCount + globalHandlers.size());
+    handlers.insert(handlers.end(), globalHandlers.cbegin(), globalHandlers.cend());
+    const Run global{0, (uint32_t)handlers.size()};
+
+    auto copy = [this, &handlers, &globalHandlers, globalCount] (const Run& run)
+    {
+      const uint32_t first = (uint32_t)handlers.size();
+      handlers.insert(handlers.end(), globalHandlers.cbegin(), globalHandlers.cend());
+      handlers.insert(handlers.end(), _handlers.cbegin() + run.first + globalCount, _handlers.cbegin() + run.last);
+      return Run{first, (uint32_t)handlers.size()};
+    };
+
+    for(auto& run : _dense)
+    {
+      run = (run == _global) ? global : copy(run);
+    }
+
+    for(auto& it : _sparse)
+    {
+      it.second = copy(it.second);
+    }
+
+    _handlers.swap(handlers);
+    _global = global;
+    _unused = 0;
+  }
+
+  /**
+   * @param run  Run of handlers
+   * @return  Handlers in the run
+   */
+  inline Handlers handlers(const Run& run) const noexcept
+  { return Handlers{_handlers.data() + run.first, _handlers.data() + run.last}; }
+
+  std::vector<T> _handlers;                     ///< Runs of handlers, global handlers first
+  Run _global;                                  ///< Run of the global handlers
+  std::vector<Run> _dense;                      ///< Runs of types below DenseLimit, indexed by type
+  std::unordered_map<EventType, Run> _sparse;   ///< Runs of subscribed types of at least DenseLimit
+  size_t _unused;                               ///< Number of handler entries in replaced runs
+};
+
+template<typename T>
+constexpr EventType BasicDispatchTable<T>::DenseLimit;
+
+/** @brief  Dispatch table of event handler pointers, used by SimEngine */
+typedef BasicDispatchTable<EventHandler*> DispatchTable;
+
+/** @} */
+} // End namespace
+
+#endif
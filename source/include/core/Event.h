@@ -13,13 +13,18 @@ namespace des
 class Event
 {
 public:
+  static constexpr HandlerId NoTarget = 0;   ///< Target of events passed to all subscribed handlers
+
   /**
    * @brief  Construct event from time, type, and tag
    * @param evtTime  Event occurrence time
    * @param evtType  Event type
    * @param evtTag  Event tag (optional, default = 0)
+   * @param evtPriority  Event priority, events with equal times are handled in descending priority (optional, default = 0)
+   * @param evtTarget  Id of the only handler to receive the event, from SimEngine::registerTarget (optional, default = NoTarget)
    */
-  Event(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0) noexcept;
+  Event(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0,
+    const EventPriority evtPriority = 0, const HandlerId evtTarget = NoTarget) noexcept;
 
   /** @brief  Default copy constructor */
   Event(const Event&) = default;
@@ -47,12 +52,25 @@ public:
   inline EventTag tag() const noexcept
   { return _tag; }
 
+  /** @return  Event priority */
+  inline EventPriority priority() const noexcept
+  { return _priority; }
+
+  /** @return  Id of the only handler to receive the event, NoTarget if the event is passed to all subscribed handlers */
+  inline HandlerId target() const noexcept
+  { return _target; }
+
 private:
-  SimTime _time;      ///< Event occurrence time
-  EventType _type;    ///< Event type
-  EventTag _tag;      ///< Event tag
+  SimTime _time;            ///< Event occurrence time
+  EventType _type;          ///< Event type
+  EventTag _tag;            ///< Event tag
+  EventPriority _priority;  ///< Event priority
+  HandlerId _target;        ///< Id of the handler to receive the event, fits in the padding after the priority
 };
 
+// Queues and batches copy events by value, keep them at three words
+static_assert(sizeof(Event) == 24, "Event must stay 24 bytes");
+
 /** @} */
 } // End namespace
 
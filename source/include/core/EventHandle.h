@@ -0,0 +1,81 @@
+#ifndef __DES_EVENTHANDLE_H__
+#define __DES_EVENTHANDLE_H__
+
+#include "DESCommon.h"
+#include <cstdint>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+class EventQueue;
+
+/**
+ * @brief  Handle to an event in an EventQueue
+ *
+ *  Allows a pending event to be cancelled or moved to a different time.  A handle
+ *  stops referring to its event once the event is removed from the queue, after
+ *  which cancel and reschedule have no effect.  Handles must not outlive their
+ *  queue, and are invalidated if the queue is moved.
+ */
+class EventHandle
+{
+public:
+  /** @brief  Construct a handle not referring to any event */
+  EventHandle() noexcept :
+    _queue{nullptr},
+    _id{0}
+  {}
+
+  /** @brief  Default copy constructor */
+  EventHandle(const EventHandle&) = default;
+
+  /** @brief  Default copy assignment operator */
+  EventHandle& operator = (const EventHandle&) = default;
+
+  /**
+   * @brief  Remove the event from its queue
+   * @return  True if the event was removed, false if it was no longer pending
+   */
+  bool cancel();
+
+  /**
+   * @brief  Move the event to a new time
+   * @param newTime  New event time
+   * @return  True if the event was moved, false if it was no longer pending
+   */
+  bool reschedule(const SimTime newTime);
+
+  /** @return  True if the event is still in its queue, false otherwise */
+  bool pending() const;
+
+  /** @return  Queue holding the event, null if the handle was default constructed */
+  inline const EventQueue* queue() const noexcept
+  { return _queue; }
+
+  /** @return  Identifier of the event within its queue */
+  inline uint64_t id() const noexcept
+  { return _id; }
+
+private:
+  friend class EventQueue;
+
+  /**
+   * @param queue  Queue holding the event
+   * @param id  Identifier of the event within the queue
+   */
+  EventHandle(EventQueue* queue, const uint64_t id) noexcept :
+    _queue{queue},
+    _id{id}
+  {}
+
+  EventQueue* _queue;   ///< Queue holding the event
+  uint64_t _id;         ///< Identifier of the event within the queue
+};
+
+/** @} */
+} // End namespace
+
+#endif
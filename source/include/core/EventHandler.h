@@ -3,6 +3,7 @@
 
 #include "DESCommon.h"
 #include "Event.h"
+#include "EventSpan.h"
 
 namespace des
 {
@@ -27,6 +28,23 @@ public:
    */
   virtual void handleEvent(SimEngine& sim, const Event& evt) = 0;
 
+  /**
+   * @brief  Handle a batch of simultaneous events of one event type
+   * 
+   * Called instead of handleEvent when the simulation processes events in batches
+   * The default implementation calls handleEvent with each event in order
+   * 
+   * @param sim  Simulation processing the events
+   * @param events  Events to handle, all with the same time and type
+   */
+  virtual void handleEvents(SimEngine& sim, EventSpan events)
+  {
+    for(const auto& evt : events)
+    {
+      handleEvent(sim, evt);
+    }
+  }
+
   /**
    * @brief  Initialize the event handler
    * 
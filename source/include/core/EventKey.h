@@ -0,0 +1,112 @@
+#ifndef __DES_EVENTKEY_H__
+#define __DES_EVENTKEY_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include <cstdint>
+#include <stdexcept>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Packed sort key of a queued event
+ *
+ *  Orders events by time, then by an order word holding the inverted event
+ *  priority above the insertion sequence, so events with equal times are
+ *  returned in descending priority and then in insertion order.  Together the
+ *  two words form a single 128 bit key.
+ */
+struct EventKey
+{
+  static constexpr unsigned SequenceBits = 48;    ///< Number of order word bits holding the insertion sequence
+  static constexpr uint64_t SequenceLimit = (uint64_t)1 << SequenceBits;   ///< Number of insertion sequences that fit in an order word
+
+  /**
+   * @brief  Check that an insertion sequence fits in an order word
+   *
+   * A queue running out of sequences would otherwise wrap and return later
+   * insertions with equal times and priorities before earlier ones.
+   *
+   * @param sequence  Insertion sequence
+   * @return  The sequence
+   * @throws std::overflow_error if the sequence does not fit, after 2^48 insertions into one queue
+   */
+  static inline uint64_t Checked(const uint64_t sequence)
+  {
+    if(sequence >= SequenceLimit)
+    {
+      throw std::overflow_error("Event insertion sequence exhausted");
+    }
+
+    return sequence;
+  }
+
+  /**
+   * @brief  Take the next insertion sequence of a queue
+   * @param next  Next insertion sequence of the queue, incremented
+   * @return  Insertion sequence
+   * @throws std::overflow_error if the queue has used all 2^48 sequences
+   */
+  static inline uint64_t Next(uint64_t& next)
+  {
+    const uint64_t sequence = Checked(next);
+    ++next;
+    return sequence;
+  }
+
+  /**
+   * @brief  Build an order word
+   * @param priority  Event priority
+   * @param sequence  Insertion sequence, below SequenceLimit
+   * @return  Order word
+   */
+  static inline uint64_t Order(const EventPriority priority, const uint64_t sequence) noexcept
+  {
+    return ((uint64_t)(EventPriority)~priority << SequenceBits) | (sequence & (SequenceLimit - 1));
+  }
+
+  /**
+   * @brief  Recover the event priority from an order word
+   * @param order  Order word
+   * @return  Event priority
+   */
+  static inline EventPriority Priority(const uint64_t order) noexcept
+  { return (EventPriority)~(EventPriority)(order >> SequenceBits); }
+
+  /**
+   * @brief  Build the key of an event
+   * @param e  Event
+   * @param sequence  Insertion sequence of the event
+   * @return  Sort key
+   */
+  static inline EventKey Make(const Event& e, const uint64_t sequence) noexcept
+  { return EventKey{e.time(), Order(e.priority(), sequence)}; }
+
+  SimTime time;     ///< Event time
+  uint64_t order;   ///< Inverted priority and insertion sequence
+};
+
+/**
+ * @brief  Compare two keys as one 128 bit value, without branching on the time
+ * @param lhs  Left-hand key
+ * @param rhs  Right-hand key
+ * @return  True if the left-hand key orders before the right-hand key
+ */
+inline bool operator < (const EventKey& lhs, const EventKey& rhs) noexcept
+{ return (lhs.time < rhs.time) | ((lhs.time == rhs.time) & (lhs.order < rhs.order)); }
+
+/** @brief  Event stored together with its sort key */
+struct KeyedEvent
+{
+  EventKey key;   ///< Sort key
+  Event event;    ///< Queued event
+};
+
+/** @} */
+} // End namespace
+
+#endif
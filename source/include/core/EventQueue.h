@@ -3,9 +3,14 @@
 
 #include "DESCommon.h"
 #include "Event.h"
-#include <queue>
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include "EventHandle.h"
+#include "RingBuffer.h"
+#include <memory>
 #include <vector>
-#include <functional>
+#include <set>
+#include <unordered_map>
 
 namespace des
 {
@@ -13,11 +18,46 @@ namespace des
 * @{
 */
 
-/** @brief  Queue of events sorted by time */
+/**
+ * @brief  Queue of events sorted by time
+ *
+ *  Event types that are always scheduled a constant delay ahead can be given a
+ *  lane.  Events of a lane type arrive already sorted, so they are appended to a
+ *  FIFO ring buffer in O(1) instead of being inserted into the backend, and lane
+ *  heads are merged with the backend when events are removed.  An event that
+ *  would break the order of its lane is inserted into the backend instead, so
+ *  lanes never change the order events are returned in.
+ *
+ *  Secondary indices over the pending events can be enabled, counting events per
+ *  type and ordering events per tag.  Indices are updated on every insert and
+ *  removal, adding O(log n) work to each, so they are off by default.
+ */
 class EventQueue
 {
 public:
+  /** @brief  Construct an event queue using a binary heap backend */
   EventQueue();
+
+  /**
+   * @brief  Construct an event queue using the given type of backend
+   * @param backendType  Type of backend storing the events
+   * @throws std::invalid_argument if backend type is unknown
+   */
+  explicit EventQueue(const QueueBackendType backendType);
+
+  /**
+   * @brief  Construct an event queue using the given backend
+   * @param backend  Backend storing the events, must be empty
+   * @throws std::invalid_argument if backend is null or not empty
+   */
+  explicit EventQueue(std::unique_ptr<QueueBackend> backend);
+
+  /** @brief  Default move constructor */
+  EventQueue(EventQueue&&) = default;
+
+  /** @brief  Default move assignment operator */
+  EventQueue& operator = (EventQueue&&) = default;
+
   ~EventQueue();
 
   /**
@@ -25,14 +65,14 @@ public:
    * @param e  Event to insert
    */
   inline void insert(const Event& e)
-  { _queue.push(e); }
+  { insertKeyed(e, EventKey::Make(e, EventKey::Next(_sequence))); }
 
   /**
    * @brief  Insert an event into the queue
    * @param e  Event to insert
    */
   inline void insert(Event&& e)
-  { _queue.push(std::move(e)); }
+  { insertKeyed(e, EventKey::Make(e, EventKey::Next(_sequence))); }
 
   /**
    * @brief  Insert an event with the given parameters into the queue
@@ -40,9 +80,108 @@ public:
    * @param evtTime  Event time
    * @param evtType  Event type
    * @param evtTag  Event tag
+   * @param evtPriority  Event priority
    */
-  inline void insert(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0)
-  { _queue.emplace(evtTime, evtType, evtTag); }
+  inline void insert(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0,
+    const EventPriority evtPriority = 0)
+  { insert(Event{evtTime, evtType, evtTag, evtPriority}); }
+
+  /**
+   * @brief  Insert a range of events into the queue
+   *
+   *  Events are appended and the queue order is rebuilt once, in linear time
+   *  for backends that support it.  Events are not placed in lanes.
+   *
+   * @param first  Iterator to the first event
+   * @param last  Iterator following the last event
+   */
+  template<typename InputIt>
+  void insertRange(InputIt first, InputIt last)
+  {
+    size_t appended = 0;
+    try
+    {
+      for(; first != last; ++first)
+      {
+        const Event& e = *first;
+        const EventKey key = EventKey::Make(e, EventKey::Next(_sequence));
+        _backend->appendUnordered(e, key);
+        ++appended;
+
+        if(_indices)
+        {
+          index(KeyedEvent{key, e});
+        }
+      }
+    }
+    catch(...)
+    {
+      _backend->restoreOrder(appended);
+      throw;
+    }
+
+    _backend->restoreOrder(appended);
+  }
+
+  /**
+   * @brief  Reserve storage so that inserting events does not reallocate
+   * @param count  Number of events to reserve storage for
+   */
+  inline void reserve(const size_t count)
+  { _backend->reserve(count); }
+
+  /**
+   * @brief  Insert an event into the queue, returning a handle to it
+   *
+   *  Event is never placed in a lane
+   *
+   * @param e  Event to insert
+   * @return  Handle for cancelling or rescheduling the event
+   * @throws std::logic_error if the backend does not support handles
+   */
+  EventHandle insertWithHandle(const Event& e);
+
+  /**
+   * @brief  Insert an event with the given parameters into the queue, returning a handle to it
+   *
+   * @param evtTime  Event time
+   * @param evtType  Event type
+   * @param evtTag  Event tag
+   * @param evtPriority  Event priority
+   * @return  Handle for cancelling or rescheduling the event
+   * @throws std::logic_error if the backend does not support handles
+   */
+  inline EventHandle insertWithHandle(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0,
+    const EventPriority evtPriority = 0)
+  { return insertWithHandle(Event{evtTime, evtType, evtTag, evtPriority}); }
+
+  /**
+   * @brief  Remove an event from the queue
+   * @param handle  Handle to the event
+   * @return  True if the event was removed, false if it was no longer in the queue
+   * @throws std::invalid_argument if handle does not belong to this queue
+   */
+  bool cancel(const EventHandle& handle);
+
+  /**
+   * @brief  Move an event in the queue to a new time
+   * @param handle  Handle to the event
+   * @param newTime  New event time
+   * @return  True if the event was moved, false if it was no longer in the queue
+   * @throws std::invalid_argument if handle does not belong to this queue
+   */
+  bool reschedule(const EventHandle& handle, const SimTime newTime);
+
+  /**
+   * @param handle  Handle to an event
+   * @return  True if the event is still in the queue, false otherwise
+   * @throws std::invalid_argument if handle does not belong to this queue
+   */
+  bool pending(const EventHandle& handle) const;
+
+  /** @return  True if the backend supports event handles, false otherwise */
+  inline bool supportsHandles() const noexcept
+  { return _backend->supportsHandles(); }
 
   /**
    * @brief  Get the next event from the queue
@@ -66,17 +205,126 @@ public:
 
   /** @return  True if queue is empty, false otherwise */
   inline bool empty() const noexcept
-  { return _queue.empty(); }
+  { return (size() == 0); }
 
   /** @return  Number of events in the queue */
   inline size_t size() const noexcept
-  { return _queue.size(); }
+  { return (_backend->size() + _laneSize); }
+
+  /**
+   * @brief  Enable secondary indices over the pending events
+   * @throws std::runtime_error if queue is not empty
+   */
+  void enableIndices();
+
+  /** @return  True if secondary indices are enabled, false otherwise */
+  inline bool indexed() const noexcept
+  { return (_indices != nullptr); }
+
+  /**
+   * @param type  Event type
+   * @return  Number of events of the type in the queue, in O(1)
+   * @throws std::logic_error if indices are not enabled
+   */
+  size_t count(const EventType type) const;
+
+  /**
+   * @param tag  Event tag
+   * @return  Next occurring event with the tag, null if the queue has none, in O(1).  The event is
+   *          owned by the queue index and is only valid until the queue is next changed
+   * @throws std::logic_error if indices are not enabled
+   */
+  const Event* findNext(const EventTag tag) const;
+
+  /**
+   * @brief  Add a lane for events of a type that are always scheduled a constant delay ahead
+   * @param type  Event type
+   * @param delay  Delay events of the type are scheduled with
+   * @throws std::invalid_argument if the type already has a lane
+   */
+  void addLane(const EventType type, const SimTime delay);
+
+  /**
+   * @param type  Event type
+   * @return  True if the type has a lane, false otherwise
+   */
+  bool hasLane(const EventType type) const noexcept;
+
+  /**
+   * @param type  Event type
+   * @return  Delay events of the type are scheduled with
+   * @throws std::invalid_argument if the type has no lane
+   */
+  SimTime laneDelay(const EventType type) const;
+
+  /** @return  Number of lanes */
+  inline size_t laneCount() const noexcept
+  { return _lanes.size(); }
+
+  /**
+   * @brief  Create a backend of the given type
+   * @param backendType  Type of backend to create
+   * @return  Empty backend
+   * @throws std::invalid_argument if backend type is unknown
+   */
+  static std::unique_ptr<QueueBackend> CreateBackend(const QueueBackendType backendType);
 
 private:
-  /** @brief  Queue sorting comparator */
-  static std::function<bool(const Event&, const Event&)> QueueSorter;
+  /** @brief  Orders keyed events in ascending key order */
+  struct EarlierKey
+  {
+    inline bool operator () (const KeyedEvent& lhs, const KeyedEvent& rhs) const noexcept
+    { return (lhs.key < rhs.key); }
+  };
+
+  /** @brief  Secondary indices over the pending events */
+  struct Indices
+  {
+    std::unordered_map<EventType, size_t> typeCounts;                       ///< Number of pending events per type
+    std::unordered_map<EventTag, std::set<KeyedEvent, EarlierKey>> tagEvents;  ///< Pending events per tag in key order
+  };
+
+  /**
+   * @brief  Add an event to the indices
+   * @param e  Inserted event
+   */
+  void index(const KeyedEvent& e);
+
+  /**
+   * @brief  Remove an event from the indices
+   * @param e  Removed event
+   */
+  void unindex(const KeyedEvent& e);
+
+  /** @brief  FIFO of events of one type scheduled a constant delay ahead */
+  struct Lane
+  {
+    EventType type;                    ///< Event type
+    SimTime delay;                     ///< Delay events are scheduled with
+    RingBuffer<KeyedEvent> events;     ///< Events in key order
+  };
+
+  /**
+   * @brief  Insert an event into its lane, or into the backend if it has none or would break lane order
+   * @param e  Event to insert
+   * @param key  Sort key of the event
+   */
+  void insertKeyed(const Event& e, const EventKey& key);
+
+  /**
+   * @param type  Event type
+   * @return  Index of the lane of the type, number of lanes if it has none
+   */
+  size_t findLane(const EventType type) const noexcept;
+
+  /** @return  Index of the lane holding the next event, number of lanes if the next event is in the backend */
+  size_t nextLane() const;
 
-  std::priority_queue<Event, std::vector<Event>, decltype(QueueSorter)> _queue;   ///< Event queue
+  std::unique_ptr<QueueBackend> _backend;   ///< Data structure holding the events
+  std::vector<Lane> _lanes;                 ///< Lanes of constant-delay event types
+  size_t _laneSize;                         ///< Number of events held in lanes
+  uint64_t _sequence;                       ///< Insertion sequence of the next event
+  std::unique_ptr<Indices> _indices;        ///< Secondary indices, null unless enabled
 };
 
 /** @} */
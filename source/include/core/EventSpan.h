@@ -0,0 +1,58 @@
+#ifndef __DES_EVENTSPAN_H__
+#define __DES_EVENTSPAN_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include <cstddef>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/** @brief  Read-only view of a contiguous run of events */
+class EventSpan
+{
+public:
+  EventSpan(const Event* first, const Event* last) noexcept :
+    _first{first},
+    _last{last}
+  {}
+
+  /** @return  Pointer to the first event */
+  inline const Event* begin() const noexcept
+  { return _first; }
+
+  /** @return  Pointer following the last event */
+  inline const Event* end() const noexcept
+  { return _last; }
+
+  /** @return  Pointer to the first event */
+  inline const Event* data() const noexcept
+  { return _first; }
+
+  /** @return  Number of events */
+  inline size_t size() const noexcept
+  { return (_last - _first); }
+
+  /** @return  True if the span holds no events */
+  inline bool empty() const noexcept
+  { return (_first == _last); }
+
+  /**
+   * @param index  Index of an event, must be less than size
+   * @return  Event at the index
+   */
+  inline const Event& operator [] (const size_t index) const noexcept
+  { return _first[index]; }
+
+private:
+  const Event* _first;   ///< First event
+  const Event* _last;    ///< Following the last event
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef __DES_EXTERNALMEMORYBACKEND_H__
+#define __DES_EXTERNALMEMORYBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include "io/BinaryEventReader.h"
+#include "io/BinaryEventWriter.h"
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend keeping a near-future window of events in memory and spilling far-future events to disk
+ *
+ *  Events earlier than the horizon are kept in an in-memory heap, later events
+ *  are buffered and, once the memory budget is exceeded, written to disk as a
+ *  sorted run.  When the in-memory heap runs dry the runs are merged back in key
+ *  order, refilling the heap with the next window of events.  If the heap itself
+ *  outgrows the budget, its later half is spilled and the horizon moves down.
+ *  Once there are more than MaxRuns runs the smaller half of them are merged
+ *  into one, which bounds the number of open files while rewriting each event a
+ *  logarithmic number of times.
+ *
+ *  Each run record is an event in the V2 binary layout followed by the order
+ *  word of its key.  Run files are named from the given path prefix and are
+ *  removed once merged back in or when the backend is destroyed.
+ */
+class ExternalMemoryBackend : public QueueBackend
+{
+public:
+  static constexpr size_t DefaultMemoryBudget = 64 * 1024 * 1024;  ///< Default memory budget in bytes
+  static constexpr size_t MaxRuns = 64;                             ///< Number of runs above which runs are merged
+
+  /**
+   * @brief  Construct a backend spilling to files named from the given prefix
+   * @param pathPrefix  Path prefix of the run files, runs are named prefix + index + ".run"
+   * @param memoryBudget  Maximum number of bytes of events held in memory
+   * @throws std::invalid_argument if the budget holds fewer than two events
+   */
+  explicit ExternalMemoryBackend(const std::string& pathPrefix, const size_t memoryBudget = DefaultMemoryBudget);
+  ~ExternalMemoryBackend();
+
+  using QueueBackend::insert;
+
+  /**
+   * @brief  Insert an event
+   * @param e  Event to insert
+   * @param key  Sort key of the event
+   * @throws std::runtime_error if a run file cannot be written
+   */
+  void insert(const Event& e, const EventKey& key) override;
+
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _size; }
+
+  /** @return  Maximum number of events held in memory */
+  inline size_t memoryLimit() const noexcept
+  { return _limit; }
+
+  /** @return  Number of events held in memory */
+  inline size_t memoryCount() const noexcept
+  { return (_near.size() + _far.size()); }
+
+  /** @return  Number of runs on disk holding events */
+  inline size_t runCount() const noexcept
+  { return _runs.size(); }
+
+private:
+  /** @brief  Sorted run of events on disk */
+  struct Run
+  {
+    std::string path;                           ///< Path of the run file
+    std::unique_ptr<std::ifstream> file;        ///< Run file
+    std::unique_ptr<BinaryEventReader> reader;  ///< Reader of the run file
+    size_t remaining;                           ///< Number of events not yet read
+    KeyedEvent head;                            ///< Earliest event not yet merged, valid if the run is not exhausted
+    bool exhausted;                             ///< True once all events are merged
+  };
+
+  /** @return  Path of a new run file */
+  inline std::string nextRunPath() const
+  { return _pathPrefix + std::to_string(_runIndex++) + ".run"; }
+
+  /**
+   * @brief  Write events to a new run
+   *
+   *  Events are cleared once written, and left in place if writing fails
+   *
+   * @param events  Events to write, sorted in place
+   * @throws std::runtime_error if the run file cannot be written
+   */
+  void writeRun(std::vector<KeyedEvent>& events) const;
+
+  /**
+   * @brief  Merge the smaller half of the runs into one while there are more than MaxRuns
+   *
+   *  The runs are read through new file handles, so they are left unchanged if the merge fails
+   *
+   * @throws std::runtime_error if the merged run file cannot be written
+   */
+  void mergeRuns() const;
+
+  /**
+   * @brief  Open a written run file and read its first event
+   * @param path  Path of the run file
+   * @param count  Number of events in the run
+   * @return  Opened run
+   * @throws std::runtime_error if the run file cannot be read
+   */
+  static Run OpenRun(const std::string& path, const size_t count);
+
+  /**
+   * @brief  Write an event record to a run file
+   * @param writer  Writer of the run file
+   * @param e  Event to write
+   */
+  static void WriteRecord(BinaryEventWriter& writer, const KeyedEvent& e);
+
+  /**
+   * @brief  Advance a run to its next event
+   * @param run  Run to advance
+   * @throws std::runtime_error if the run file cannot be read
+   */
+  static void ReadHead(Run& run);
+
+  /** @brief  Write events to disk until the events in memory fit the budget */
+  void spill();
+
+  /** @brief  Ensure the next event is at the top of the in-memory heap */
+  void refill() const;
+
+  std::string _pathPrefix;   ///< Path prefix of the run files
+  size_t _limit;             ///< Maximum number of events held in memory
+
+  mutable size_t _runIndex;                ///< Index of the next run file
+  mutable std::vector<KeyedEvent> _near;   ///< Heap of events earlier than the horizon
+  mutable std::vector<KeyedEvent> _far;    ///< Unsorted events no earlier than the horizon, not yet spilled
+  mutable std::vector<Run> _runs;          ///< Runs on disk, all events no earlier than the horizon
+  mutable EventKey _horizon;               ///< Key separating events in the heap from all other events
+
+  size_t _size;   ///< Number of events held
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef __DES_LADDERQUEUEBACKEND_H__
+#define __DES_LADDERQUEUEBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include <vector>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend storing events in a ladder queue
+ *
+ *  Far-future events are appended to an unsorted Top list.  When the nearer
+ *  structures run empty, Top is spread over the buckets of a Ladder rung sized
+ *  from the number and time span of its events.  Buckets are consumed in order,
+ *  and a bucket holding more than Threshold events spawns a finer rung instead of
+ *  being sorted, so bursts of events at nearly the same time are split up rather
+ *  than piling into one bucket.  Only the current bucket is ordered, as a binary
+ *  heap in Bottom, from which events are removed, and Bottom growing past
+ *  Threshold is spread over a new rung in the same way.  Insert and removal are
+ *  O(1) amortized regardless of how event times are distributed.
+ *
+ *  Rungs size their buckets from the times of the events they are spawned with,
+ *  and the last bucket of a rung extends to the end of the time range the rung
+ *  covers, so a far-future outlier does not leave the nearer events in one bucket.
+ */
+class LadderQueueBackend : public QueueBackend
+{
+public:
+  LadderQueueBackend();
+  ~LadderQueueBackend();
+
+  using QueueBackend::insert;
+  void insert(const Event& e, const EventKey& key) override;
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _size; }
+
+  /** @return  Number of rungs currently in the ladder */
+  inline size_t rungCount() const noexcept
+  { return _rungs.size(); }
+
+  static constexpr size_t Threshold = 50;   ///< Bucket size above which a new rung is spawned
+  static constexpr size_t MaxRungs = 8;     ///< Maximum number of rungs in the ladder
+
+private:
+  /** @brief  Rung of the ladder */
+  struct Rung
+  {
+    SimTime start;      ///< Start time of the first bucket
+    SimTime width;      ///< Time span of each bucket but the last
+    SimTime last;       ///< Latest time covered by the last bucket
+    size_t current;     ///< Index of the next bucket to consume
+    size_t count;       ///< Number of events in the rung
+    std::vector<std::vector<KeyedEvent>> buckets;   ///< Unsorted buckets
+  };
+
+  /**
+   * @brief  Add a rung to the bottom of the ladder
+   *
+   *  Buckets are sized from the span of the events, with the last bucket
+   *  extended to cover any time up to last
+   *
+   * @param events  Events to spread over the rung
+   * @param start  Earliest event time
+   * @param last  Latest time the rung must cover
+   * @return  Time following the end of the rung, saturated to the maximum SimTime
+   */
+  SimTime spawnRung(const std::vector<KeyedEvent>& events, const SimTime start, const SimTime last) const;
+
+  /**
+   * @brief  Insert an event into Bottom, keeping it ordered
+   *
+   *  Bottom is spread over a new rung once it holds more than Threshold events,
+   *  unless they all occur at the same time
+   *
+   * @param e  Event to insert
+   */
+  void insertBottom(const KeyedEvent& e);
+
+  /** @brief  Move events down from Top and the ladder until Bottom holds the next event */
+  void refill() const;
+
+  mutable std::vector<KeyedEvent> _top;     ///< Unsorted far-future events
+  mutable SimTime _topStart;                ///< Earliest time of events added to Top
+  mutable SimTime _topMin;                  ///< Earliest time of events in Top
+  mutable SimTime _topMax;                  ///< Latest time of events in Top
+
+  mutable std::vector<Rung> _rungs;         ///< Ladder rungs, each nested within a bucket of the rung above
+  mutable std::vector<KeyedEvent> _bottom;  ///< Binary heap of events with the earliest event at the front
+  mutable size_t _spillSize;                ///< Bottom size above which it is spread over a new rung
+
+  size_t _size;                             ///< Number of events held
+};
+
+/** @} */
+} // End namespace
+
+#endif
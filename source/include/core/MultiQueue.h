@@ -0,0 +1,117 @@
+#ifndef __DES_MULTIQUEUE_H__
+#define __DES_MULTIQUEUE_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Relaxed concurrent priority queue of events, safe to use from several threads
+ *
+ *  Events are spread over several independently locked binary heaps.  Insert
+ *  pushes into a random heap, and removal pops from the better of two random
+ *  heaps, so threads rarely contend for the same lock.  The price is relaxed
+ *  order: the removed event is not always the earliest one.  With Q heaps the
+ *  expected rank error of a removed event, the number of events held that are
+ *  earlier than it, is O(Q), independent of the number of events held, and
+ *  large rank errors are exponentially unlikely.  A single heap gives exact order.
+ *
+ *  Each heap caches the time of its earliest event so two heaps can be compared
+ *  without locking either of them.
+ */
+class MultiQueue
+{
+public:
+  /**
+   * @brief  Construct a queue with the given number of heaps
+   * @param queueCount  Number of heaps, a small multiple of the number of threads using the queue
+   * @throws std::invalid_argument if queueCount is zero
+   */
+  explicit MultiQueue(const size_t queueCount);
+
+  /** @brief  Construct a queue with two heaps per hardware thread */
+  MultiQueue();
+
+  ~MultiQueue();
+
+  MultiQueue(const MultiQueue&) = delete;
+  MultiQueue& operator = (const MultiQueue&) = delete;
+
+  /**
+   * @brief  Insert an event into the queue
+   * @param e  Event to insert
+   */
+  void insert(const Event& e);
+
+  /**
+   * @brief  Insert an event with the given parameters into the queue
+   *
+   * @param evtTime  Event time
+   * @param evtType  Event type
+   * @param evtTag  Event tag
+   * @param evtPriority  Event priority
+   */
+  inline void insert(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0,
+    const EventPriority evtPriority = 0)
+  { insert(Event{evtTime, evtType, evtTag, evtPriority}); }
+
+  /**
+   * @brief  Remove one of the earliest events from the queue
+   * @param e  Set to the removed event
+   * @return  True if an event was removed, false if the queue was found empty
+   */
+  bool tryGetNext(Event& e);
+
+  /** @return  Number of events in the queue, exact only while no other thread modifies the queue */
+  inline size_t size() const noexcept
+  { return _size.load(std::memory_order_relaxed); }
+
+  /** @return  True if queue is empty, exact only while no other thread modifies the queue */
+  inline bool empty() const noexcept
+  { return (size() == 0); }
+
+  /** @return  Number of heaps */
+  inline size_t queueCount() const noexcept
+  { return _heaps.size(); }
+
+private:
+  /** @brief  Binary heap of events with its own lock */
+  struct Heap
+  {
+    Heap();
+
+    std::mutex lock;                  ///< Lock guarding the events
+    std::vector<KeyedEvent> events;   ///< Events ordered as a heap
+    std::atomic<SimTime> top;         ///< Time of the earliest event, maximal if the heap is empty
+  };
+
+  /** @return  Index of a heap chosen at random, using a generator local to the calling thread */
+  size_t randomHeap() const;
+
+  /**
+   * @brief  Remove the earliest event from a heap, which must be locked by the caller
+   * @param heap  Heap to remove from
+   * @param e  Set to the removed event
+   * @return  True if an event was removed, false if the heap was empty
+   */
+  bool pop(Heap& heap, Event& e);
+
+  std::vector<std::unique_ptr<Heap>> _heaps;   ///< Heaps holding the events
+  std::atomic<size_t> _size;                   ///< Number of events held
+  std::atomic<uint64_t> _sequence;             ///< Insertion sequence of the next event
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef __DES_PARTITIONEDBACKEND_H__
+#define __DES_PARTITIONEDBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include <vector>
+#include <cstdint>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend splitting events into partitions by event type, merged through a tournament tree
+ *
+ *  Each partition is a small binary heap holding the events of the types assigned
+ *  to it, so a handler rescheduling its own event types works on a small heap that
+ *  stays in cache instead of sifting through every pending event.  The next event
+ *  is selected by a tournament tree over the partition heads.  Inserting an event
+ *  only updates the tree when the event becomes the head of its partition, and
+ *  removing an event replays the path of one partition, so both cost
+ *  O(log(n / P) + log P) for P partitions.
+ *
+ *  Event types are assigned to partitions by their value modulo the number of
+ *  partitions, so consecutive event types land in different partitions.
+ */
+class PartitionedBackend : public QueueBackend
+{
+public:
+  static constexpr size_t DefaultPartitions = 16;   ///< Number of partitions used by default
+
+  /**
+   * @brief  Construct a backend with the given number of partitions
+   * @param partitionCount  Number of partitions
+   * @throws std::invalid_argument if partitionCount is zero
+   */
+  explicit PartitionedBackend(const size_t partitionCount = DefaultPartitions);
+  ~PartitionedBackend();
+
+  using QueueBackend::insert;
+  void insert(const Event& e, const EventKey& key) override;
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _size; }
+
+  /** @return  Number of partitions */
+  inline size_t partitionCount() const noexcept
+  { return _partitions.size(); }
+
+  /**
+   * @param type  Event type
+   * @return  Index of the partition holding events of the type
+   */
+  inline size_t partition(const EventType type) const noexcept
+  { return (type % _partitions.size()); }
+
+private:
+  /** @brief  Tournament tree node, holding the head key and partition of the winner of a subtree */
+  struct Node
+  {
+    EventKey key;         ///< Key of the earliest event in the subtree, maximal if the subtree is empty
+    uint32_t partition;   ///< Partition holding the earliest event in the subtree
+  };
+
+  /**
+   * @brief  Update the tree after the head of a partition changed
+   * @param index  Index of the partition
+   */
+  void replay(const size_t index) noexcept;
+
+  std::vector<std::vector<KeyedEvent>> _partitions;   ///< Heaps of events, one per partition
+  std::vector<Node> _tree;                            ///< Tournament tree, root at 1, leaves for each partition from _leaves
+  size_t _leaves;                                     ///< Number of leaves, a power of two
+  size_t _size;                                       ///< Number of events held
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef __DES_QUEUEBACKEND_H__
+#define __DES_QUEUEBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/** @brief  Data structures available for storing the events of an EventQueue */
+enum class QueueBackendType
+{
+  BinaryHeap,       ///< Binary heap
+  CalendarQueue,    ///< Calendar queue with automatic bucket resizing
+  RadixHeap,        ///< Radix heap, fastest when event times never precede the last removed event
+  TimingWheel,      ///< Hierarchical timing wheel, fastest when most events are scheduled a short delay ahead
+  LadderQueue,      ///< Ladder queue, robust to skewed event time distributions
+  QuaternaryHeap,   ///< Cache-aligned 4-ary heap
+  OctonaryHeap,     ///< Cache-aligned 8-ary heap
+  SortedArray,      ///< Sorted array, fastest with few events
+  Adaptive,         ///< Switches between a sorted array, a heap and a calendar queue as the workload changes
+  Partitioned       ///< Heaps partitioned by event type merged by a tournament tree, fastest when handlers reschedule their own event types
+};
+
+/**
+ * @brief  Interface for the data structure holding the events of an EventQueue
+ *
+ *  EventQueue performs all argument and state checking, so getNext, peekNext and
+ *  peekKey are only called on a backend that holds at least one event.  Events
+ *  are inserted with a sort key assigned by EventQueue, and backends return events
+ *  in key order, so events with equal times are returned in descending priority,
+ *  then in insertion order.
+ */
+class QueueBackend
+{
+public:
+  virtual ~QueueBackend()
+  {}
+
+  /**
+   * @brief  Insert an event
+   * @param e  Event to insert
+   * @param key  Sort key of the event
+   */
+  virtual void insert(const Event& e, const EventKey& key) = 0;
+
+  /**
+   * @brief  Insert an event keyed after all events previously inserted this way, for using a backend on its own
+   * @param e  Event to insert
+   */
+  inline void insert(const Event& e)
+  { insert(e, EventKey::Make(e, EventKey::Next(_sequence))); }
+
+  /**
+   * @brief  Insert an event as part of a bulk insertion
+   *
+   *  Order does not need to be maintained until restoreOrder is called
+   *
+   * @param e  Event to insert
+   * @param key  Sort key of the event
+   */
+  virtual void appendUnordered(const Event& e, const EventKey& key)
+  { insert(e, key); }
+
+  /**
+   * @brief  Restore order after a bulk insertion
+   * @param appended  Number of events inserted with appendUnordered since order was last restored
+   */
+  virtual void restoreOrder(const size_t appended)
+  {}
+
+  /**
+   * @brief  Reserve storage for a number of events
+   * @param count  Number of events to reserve storage for
+   */
+  virtual void reserve(const size_t count)
+  {}
+
+  /**
+   * @brief  Remove the next occurring event
+   * @return  Next occurring event
+   */
+  virtual Event getNext() = 0;
+
+  /** @return  Next occurring event, which is not removed */
+  virtual const Event& peekNext() const = 0;
+
+  /** @return  Sort key of the next occurring event */
+  virtual EventKey peekKey() const = 0;
+
+  /** @return  Number of events held */
+  virtual size_t size() const noexcept = 0;
+
+  /** @return  True if events can be tracked for cancelling and rescheduling, false otherwise */
+  virtual bool supportsHandles() const noexcept
+  { return false; }
+
+  /**
+   * @brief  Insert an event that can later be cancelled or rescheduled
+   * @param e  Event to insert
+   * @param key  Sort key of the event
+   * @return  Identifier of the event, unique among events held
+   * @throws std::logic_error if handles are not supported
+   */
+  virtual uint64_t insertTracked(const Event& e, const EventKey& key)
+  { throw std::logic_error("Backend does not support event handles"); }
+
+  /**
+   * @brief  Remove a tracked event
+   * @param id  Identifier of the event
+   * @return  True if the event was removed, false if it is no longer held
+   * @throws std::logic_error if handles are not supported
+   */
+  virtual bool cancel(const uint64_t id)
+  { throw std::logic_error("Backend does not support event handles"); }
+
+  /**
+   * @brief  Move a tracked event to a new time
+   * @param id  Identifier of the event
+   * @param newTime  New event time
+   * @param sequence  Insertion sequence for the new sort key of the event
+   * @return  True if the event was moved, false if it is no longer held
+   * @throws std::logic_error if handles are not supported
+   */
+  virtual bool reschedule(const uint64_t id, const SimTime newTime, const uint64_t sequence)
+  { throw std::logic_error("Backend does not support event handles"); }
+
+  /**
+   * @param id  Identifier of a tracked event
+   * @return  True if the event is still held, false otherwise
+   * @throws std::logic_error if handles are not supported
+   */
+  virtual bool pending(const uint64_t id) const
+  { throw std::logic_error("Backend does not support event handles"); }
+
+  /**
+   * @brief  Look up a tracked event
+   * @param id  Identifier of the event
+   * @param e  Set to the event and its sort key if it is still held
+   * @return  True if the event is still held, false otherwise
+   * @throws std::logic_error if handles are not supported
+   */
+  virtual bool lookup(const uint64_t id, KeyedEvent& e) const
+  { throw std::logic_error("Backend does not support event handles"); }
+
+protected:
+  QueueBackend() :
+    _sequence{0}
+  {}
+
+private:
+  uint64_t _sequence;   ///< Insertion sequence of the next event inserted without a key
+};
+
+/** @} */
+} // End namespace
+
+#endif
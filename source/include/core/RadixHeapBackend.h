@@ -0,0 +1,76 @@
+#ifndef __DES_RADIXHEAPBACKEND_H__
+#define __DES_RADIXHEAPBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include <vector>
+#include <limits>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend storing events in a radix heap
+ *
+ *  Relies on event times never decreasing below the time of the last removed event,
+ *  which SimEngine already requires for causality.  Events are bucketed by the
+ *  highest bit in which their time differs from the last removed time, so no
+ *  comparisons between events are needed on insert.  Each event moves to a lower
+ *  bucket at most once per bit, giving O(1) insert and amortized O(log T) removal.
+ *
+ *  Events earlier than the last removed time are still accepted and are returned
+ *  first, so causality violations can be detected by the caller.  Bucket 0 holds
+ *  only events at the last removed time, kept as a heap so they are returned in
+ *  priority and insertion order.
+ */
+class RadixHeapBackend : public QueueBackend
+{
+public:
+  RadixHeapBackend();
+  ~RadixHeapBackend();
+
+  using QueueBackend::insert;
+  void insert(const Event& e, const EventKey& key) override;
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _size; }
+
+private:
+  static constexpr size_t NumBuckets = std::numeric_limits<SimTime>::digits + 1;   ///< One bucket per bit, plus one for the last removed time
+
+  /**
+   * @brief  Get the bucket an event time belongs in
+   * @param t  Event time
+   * @param last  Last removed event time
+   * @return  Bucket index, 0 if times are equal otherwise one more than the highest differing bit
+   */
+  static size_t BucketIndex(const SimTime t, const SimTime last) noexcept;
+
+  /**
+   * @brief  Add an event to its bucket relative to the last removed time
+   * @param e  Event to place, no earlier than the last removed time
+   */
+  void place(const KeyedEvent& e) const;
+
+  /** @brief  Ensure the next event is at the top of bucket 0 or in the early heap */
+  void refill() const;
+
+  mutable std::vector<KeyedEvent> _buckets[NumBuckets];   ///< Buckets indexed by highest bit differing from the last removed time, bucket 0 is a heap
+  mutable SimTime _last;                                  ///< Time buckets are keyed from, no later than any event in the buckets
+
+  std::vector<KeyedEvent> _early;   ///< Heap of events inserted before the last removed time
+  size_t _size;                     ///< Number of events held
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef __DES_RINGBUFFER_H__
+#define __DES_RINGBUFFER_H__
+
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  FIFO queue stored in a growable ring buffer
+ *
+ *  Capacity is kept a power of two so positions wrap with a mask.  Storage
+ *  doubles when full, so push_back is amortized O(1) and pop_front is O(1).
+ *
+ * @tparam T  Type of the elements, must be copyable
+ */
+template<typename T>
+class RingBuffer
+{
+public:
+  RingBuffer() :
+    _items{},
+    _head{0},
+    _size{0}
+  {}
+
+  /**
+   * @brief  Append an element to the back
+   * @param item  Element to append
+   */
+  void push_back(const T& item)
+  {
+    if(_size == _items.size())
+    {
+      grow(item);
+    }
+
+    _items[(_head + _size) & (_items.size() - 1)] = item;
+    ++_size;
+  }
+
+  /** @brief  Remove the front element, buffer must not be empty */
+  inline void pop_front() noexcept
+  {
+    assert(_size > 0);
+
+    _head = (_head + 1) & (_items.size() - 1);
+    --_size;
+  }
+
+  /** @return  Front element, buffer must not be empty */
+  inline const T& front() const noexcept
+  {
+    assert(_size > 0);
+    return _items[_head];
+  }
+
+  /** @return  Back element, buffer must not be empty */
+  inline const T& back() const noexcept
+  {
+    assert(_size > 0);
+    return _items[(_head + _size - 1) & (_items.size() - 1)];
+  }
+
+  /** @return  Number of elements held */
+  inline size_t size() const noexcept
+  { return _size; }
+
+  /** @return  True if no elements are held, false otherwise */
+  inline bool empty() const noexcept
+  { return (_size == 0); }
+
+private:
+  static constexpr size_t InitialCapacity = 16;   ///< Capacity allocated on the first push_back
+
+  /**
+   * @brief  Double the capacity, moving the elements to the start of the new storage
+   * @param fill  Value for the unused storage, so elements need not be default constructible
+   */
+  void grow(const T& fill)
+  {
+    const size_t capacity = _items.empty() ? InitialCapacity : (_items.size() * 2);
+
+    std::vector<T> items{};
+    items.reserve(capacity);
+    for(size_t i = 0; i < _size; ++i)
+    {
+      items.push_back(_items[(_head + i) & (_items.size() - 1)]);
+    }
+
+    items.resize(capacity, fill);
+    _items.swap(items);
+    _head = 0;
+  }
+
+  std::vector<T> _items;   ///< Storage, size is zero or a power of two
+  size_t _head;            ///< Position of the front element
+  size_t _size;            ///< Number of elements held
+};
+
+template<typename T>
+constexpr size_t RingBuffer<T>::InitialCapacity;
+
+/** @} */
+} // End namespace
+
+#endif
@@ -4,9 +4,16 @@
 #include "DESCommon.h"
 #include "Event.h"
 #include "EventQueue.h"
+#include "EventHandle.h"
 #include "EventHandler.h"
+#include "EventSpan.h"
+#include "DispatchTable.h"
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <functional>
 
 namespace des
 {
@@ -22,21 +29,58 @@ enum class SimEngineState
   Error             ///< Simulation has encountered an error
 };
 
-/** @brief Simulation engine */
+/**
+ * @brief Simulation engine
+ *
+ *  Subscriptions may change in any state, so handlers can join and leave during a
+ *  run.  Changes made while an event is being dispatched, from inside a handler,
+ *  are queued and applied once the event has been passed to all its handlers, so
+ *  the dispatch loop never sees its handler list change.  A change rewrites only
+ *  the dispatch table entries of the event types it affects, and each handler's
+ *  subscriptions are indexed so removing a handler does not search the others.
+ *  Rewriting the entry of a type copies and orders its handlers, so changing the
+ *  handlers of a type costs O(handlers of the type).  A range or mask change also
+ *  checks each of the first DispatchTable::DenseLimit types it covers, and a
+ *  change to the global handlers rewrites the whole table.  Keyed subscriptions
+ *  and target registrations are O(1), as they have no table entries.
+ *
+ *  A handler joining a Running simulation, with its first subscription or target
+ *  registration, is initialized when it joins.  A handler leaving a Running
+ *  simulation, with its last subscription and registration removed, is finalized
+ *  when it leaves.
+ */
 class SimEngine
 {
 public:
+  /** @brief  Function called with each event processed by a run loop */
+  typedef std::function<void(SimEngine&, const Event&)> EventObserver;
+
+  /** @brief  Construct a simulation using a binary heap schedule */
   SimEngine();
+
+  /**
+   * @brief  Construct a simulation using the given type of schedule backend
+   * @param backendType  Type of backend storing the schedule
+   * @throws std::invalid_argument if backend type is unknown
+   */
+  explicit SimEngine(const QueueBackendType backendType);
+
+  /**
+   * @brief  Construct a simulation using the given schedule backend
+   * @param backend  Backend storing the schedule, must be empty
+   * @throws std::invalid_argument if backend is null or not empty
+   */
+  explicit SimEngine(std::unique_ptr<QueueBackend> backend);
+
   ~SimEngine();
 
   /**
    * @brief  Subscribe an event handler to all events
    * 
-   * If the handler is subscribed to any specific event types, those subscriptions will be removed
-   * Handlers may not be subscribed after the simulation has been initialized
+   * If the handler is subscribed to any specific event types or type and tag pairs, those subscriptions will be removed
+   * Handlers receive events in subscription order, resubscribing keeps the original position
    * 
    * @param handler  Handler to subscribe
-   * @throws std::runtime_error if simulation is not in the Uninitialized state
    * @throws std::invalid_argument if handler is null
    */
   void subscribe(EventHandler* handler);
@@ -45,19 +89,124 @@ public:
    * @brief  Subscribe an event handler to a specific event type
    * 
    * If the handler is subscribed to all events, that subscrption will be removed
-   * Handlers may not be subscribed after the simulation has been initialized
+   * Handlers receive events in subscription order, resubscribing keeps the original position
    * 
    * @param handler  Handler to subscribe
    * @param evtType  Event type to subscribe to
-   * @throws std::runtime_error if simulation is not in the Uninitialized state
    * @throws std::invalid_argument if handler is null
    */
   void subscribe(EventHandler* handler, EventType evtType);
 
+  /**
+   * @brief  Subscribe an event handler to the events of a type with a specific tag
+   * 
+   * Each type and tag pair is owned by at most one handler, so events are routed straight to it
+   * without a search.  Keyed handlers receive an event after the global and type handlers, and a
+   * handler also subscribed to the type, directly or through a range or mask, receives it only once.
+   * If the handler is subscribed to all events, that subscription will be removed
+   * 
+   * @param handler  Handler to subscribe
+   * @param evtType  Event type to subscribe to
+   * @param evtTag  Event tag to subscribe to
+   * @throws std::invalid_argument if handler is null
+   * @throws std::invalid_argument if another handler is subscribed to the type and tag, or has queued a
+   *  subscription to them while the current event is being dispatched
+   */
+  void subscribe(EventHandler* handler, EventType evtType, EventTag evtTag);
+
+  /**
+   * @brief  Subscribe an event handler to a range of event types
+   * 
+   * Ranges are resolved into the dispatch table when subscriptions are compiled, so the handler does
+   * not see events of other types.  A handler receives each event once, however many of its
+   * subscriptions match it.  Handlers matching an event type through a range or mask receive events
+   * after the handlers subscribed to the type itself.
+   * If the handler is subscribed to all events, that subscription will be removed
+   * 
+   * @param handler  Handler to subscribe
+   * @param firstType  First event type of the range
+   * @param lastType  Last event type of the range
+   * @throws std::invalid_argument if handler is null
+   * @throws std::invalid_argument if firstType is greater than lastType
+   */
+  void subscribeRange(EventHandler* handler, const EventType firstType, const EventType lastType);
+
+  /**
+   * @brief  Subscribe an event handler to the event types in a category given by a bitmask
+   * 
+   * The handler receives events whose type has the bits set in the mask equal to value, for example
+   * mask 0xFF00 and value 0x0100 select the types 0x0100 to 0x01FF.  Masks are resolved into the
+   * dispatch table in the same way as ranges.
+   * If the handler is subscribed to all events, that subscription will be removed
+   * 
+   * @param handler  Handler to subscribe
+   * @param mask  Bits of the event type that select the category
+   * @param value  Value of the selected bits in the category
+   * @throws std::invalid_argument if handler is null
+   * @throws std::invalid_argument if value has bits set outside the mask
+   */
+  void subscribeMask(EventHandler* handler, const EventType mask, const EventType value);
+
+  /**
+   * @brief  Remove all subscriptions of an event handler
+   * 
+   * The handler is also removed as a target, pending events addressed to it are discarded, and its
+   * priority is reset.  A handler leaving a Running simulation is finalized.
+   * 
+   * @param handler  Handler to unsubscribe
+   * @throws std::invalid_argument if handler is null
+   */
+  void unsubscribe(EventHandler* handler);
+
+  /**
+   * @brief  Remove the subscription of an event handler to a specific event type
+   * 
+   * A handler left without subscriptions or a target registration leaves the simulation as if unsubscribed
+   * 
+   * @param handler  Handler to unsubscribe
+   * @param evtType  Event type to unsubscribe from
+   * @throws std::invalid_argument if handler is null
+   */
+  void unsubscribe(EventHandler* handler, EventType evtType);
+
+  /**
+   * @brief  Register an event handler as the target of addressed events
+   * 
+   * Events carrying the returned id as their target are passed to the handler only, without
+   * looking up subscriptions.  Registered handlers are initialized and finalized with the
+   * subscribed handlers, a handler registered while an event is being dispatched is initialized
+   * once the event has reached all its handlers.  Registering a handler again returns the same id.
+   * 
+   * @param handler  Handler to register
+   * @return Id to address events to the handler with
+   * @throws std::invalid_argument if handler is null
+   */
+  HandlerId registerTarget(EventHandler* handler);
+
+  /**
+   * @brief  Set the dispatch priority of an event handler
+   * 
+   * Handlers with higher priority receive events first, handlers with equal priority receive events
+   * in the order they were subscribed.  Global handlers always receive events before type handlers.
+   * Handlers have priority 0 unless set.
+   * 
+   * @param handler  Handler to set the priority of
+   * @param priority  Dispatch priority
+   * @throws std::invalid_argument if handler is null
+   */
+  void setHandlerPriority(EventHandler* handler, const HandlerPriority priority);
+
+  /**
+   * @param handler  Event handler
+   * @return Dispatch priority of the handler
+   */
+  HandlerPriority handlerPriority(EventHandler* handler) const noexcept;
+
   /**
    * @brief  Initialize the simulation
    * 
-   * Calls initialize on all subscribed event handlers
+   * Calls initialize on all subscribed event handlers, then compiles the subscriptions into the dispatch table
+   * Handlers joining later are initialized when they join
    * Simulation will be in the Running state after calling initialize
    * 
    * @throws std::runtime_error if simulation is not in the Uninitialized state
@@ -74,6 +223,89 @@ public:
    */
   Event step();
 
+  /**
+   * @brief  Advance the simulation one batch, processing all events at the earliest scheduled time
+   * 
+   * Events are passed to handlers through handleEvents, one span per run of events of the same type
+   * and target.
+   * Each handler receives a whole span before the next handler is called.  Events scheduled at the
+   * batch time by the handlers are processed in the next batch.
+   * 
+   * @param groupByType  If true, events are grouped into one span per event type and target in increasing
+   *  type order, otherwise spans follow the schedule order
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws std::runtime_error if the schedule is empty
+   * @throws CausalityException if the events being processed occur before the current simulation time
+   */
+  size_t stepBatch(const bool groupByType = false);
+
+  /**
+   * @brief  Process events until the schedule is empty
+   * 
+   * State is checked once before the loop, so each event costs only its removal and dispatch
+   * 
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  size_t run();
+
+  /**
+   * @brief  Process events until the schedule is empty, calling an observer after each event
+   * 
+   * @param observer  Called with each event after it has been passed to all handlers
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws std::invalid_argument if observer is empty
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  size_t run(const EventObserver& observer);
+
+  /**
+   * @brief  Process all events occurring at or before a stop time
+   * 
+   * @param stopTime  Time of the last events to process
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  size_t runUntil(const SimTime stopTime);
+
+  /**
+   * @brief  Process all events occurring at or before a stop time, calling an observer after each event
+   * 
+   * @param stopTime  Time of the last events to process
+   * @param observer  Called with each event after it has been passed to all handlers
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws std::invalid_argument if observer is empty
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  size_t runUntil(const SimTime stopTime, const EventObserver& observer);
+
+  /**
+   * @brief  Process up to a number of events, stopping early if the schedule empties
+   * 
+   * @param count  Maximum number of events to process
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  size_t runFor(const size_t count);
+
+  /**
+   * @brief  Process up to a number of events, calling an observer after each event
+   * 
+   * @param count  Maximum number of events to process
+   * @param observer  Called with each event after it has been passed to all handlers
+   * @return Number of events processed
+   * @throws std::runtime_error if simulation is not in the Running state
+   * @throws std::invalid_argument if observer is empty
+   * @throws CausalityException if an event being processed occurs before the current simulation time
+   */
+  size_t runFor(const size_t count, const EventObserver& observer);
+
   /**
    * @brief  Finalize the simulation
    * 
@@ -105,9 +337,98 @@ public:
    * @param evtTime  Event time
    * @param evtType  Event type
    * @param evtTag  Event tag
+   * @param evtPriority  Event priority
+   */
+  inline void insertEvent(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0,
+    const EventPriority evtPriority = 0)
+  { _schedule.insert(evtTime, evtType, evtTag, evtPriority); }
+
+  /**
+   * @brief  Insert an event addressed to a single handler into the simulation schedule
+   * 
+   * The handler is registered as a target if it is not already
+   * 
+   * @param target  Handler to receive the event
+   * @param evtTime  Event time
+   * @param evtType  Event type
+   * @param evtTag  Event tag
+   * @param evtPriority  Event priority
+   * @throws std::invalid_argument if target is null
+   */
+  inline void insertTargetedEvent(EventHandler* target, const SimTime evtTime, const EventType evtType,
+    const EventTag evtTag = 0, const EventPriority evtPriority = 0)
+  { _schedule.insert(Event{evtTime, evtType, evtTag, evtPriority, registerTarget(target)}); }
+
+  /**
+   * @brief  Add a lane for an event type that is always scheduled a constant delay ahead
+   *
+   * Events of the type are appended to a FIFO in O(1) instead of being sorted
+   * into the schedule.  Events that are not in delay order are still accepted
+   * and are sorted into the schedule as usual.
+   *
+   * @param evtType  Event type
+   * @param delay  Delay events of the type are scheduled with
+   * @throws std::invalid_argument if the event type already has a lane
+   */
+  inline void addEventLane(const EventType evtType, const SimTime delay)
+  { _schedule.addLane(evtType, delay); }
+
+  /**
+   * @brief  Insert an event of a lane type, scheduled the lane delay after the current simulation time
+   *
+   * @param evtType  Event type
+   * @param evtTag  Event tag
+   * @param evtPriority  Event priority
+   * @throws std::invalid_argument if the event type has no lane
    */
-  inline void insertEvent(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0)
-  { _schedule.insert(evtTime, evtType, evtTag); }
+  inline void insertDelayedEvent(const EventType evtType, const EventTag evtTag = 0,
+    const EventPriority evtPriority = 0)
+  { _schedule.insert(_time + _schedule.laneDelay(evtType), evtType, evtTag, evtPriority); }
+
+  /**
+   * @brief  Insert a range of events into the simulation schedule
+   *
+   * Faster than inserting events individually when loading many events at once
+   *
+   * @param first  Iterator to the first event
+   * @param last  Iterator following the last event
+   */
+  template<typename InputIt>
+  inline void insertEvents(InputIt first, InputIt last)
+  { _schedule.insertRange(first, last); }
+
+  /**
+   * @brief  Reserve storage in the simulation schedule
+   * @param count  Number of events to reserve storage for
+   */
+  inline void reserveEvents(const size_t count)
+  { _schedule.reserve(count); }
+
+  /**
+   * @brief  Insert an event into the simulation schedule, returning a handle to it
+   *
+   * The handle can be used to cancel or reschedule the event while it is pending
+   *
+   * @param evt  Event to insert
+   * @return  Handle to the scheduled event
+   * @throws std::logic_error if the schedule backend does not support handles
+   */
+  inline EventHandle insertEventWithHandle(const Event& evt)
+  { return _schedule.insertWithHandle(evt); }
+
+  /**
+   * @brief  Insert an event with the given parameters into the simulation schedule, returning a handle to it
+   * 
+   * @param evtTime  Event time
+   * @param evtType  Event type
+   * @param evtTag  Event tag
+   * @param evtPriority  Event priority
+   * @return  Handle to the scheduled event
+   * @throws std::logic_error if the schedule backend does not support handles
+   */
+  inline EventHandle insertEventWithHandle(const SimTime evtTime, const EventType evtType, const EventTag evtTag = 0,
+    const EventPriority evtPriority = 0)
+  { return _schedule.insertWithHandle(evtTime, evtType, evtTag, evtPriority); }
 
   /** @return True if simulation has an event in the schedule, false otherwise */
   inline bool hasNextEvent() const noexcept
@@ -117,6 +438,30 @@ public:
   inline size_t eventCount() const noexcept
   { return _schedule.size(); }
 
+  /**
+   * @brief  Enable indices over the schedule, for counting events by type and finding events by tag
+   * @throws std::runtime_error if the schedule is not empty
+   */
+  inline void enableEventIndices()
+  { _schedule.enableIndices(); }
+
+  /**
+   * @param evtType  Event type
+   * @return Number of events of the type in the schedule
+   * @throws std::logic_error if indices are not enabled
+   */
+  inline size_t eventCount(const EventType evtType) const
+  { return _schedule.count(evtType); }
+
+  /**
+   * @param evtTag  Event tag
+   * @return Next scheduled event with the tag, null if the schedule has none.  The event is only
+   *         valid until the schedule is next changed, copy it to keep it across inserts or steps
+   * @throws std::logic_error if indices are not enabled
+   */
+  inline const Event* findNextEvent(const EventTag evtTag) const
+  { return _schedule.findNext(evtTag); }
+
   /**
    * @brief  Get the simulation time of the most recently processed event
    * 
@@ -131,7 +476,7 @@ public:
   inline SimEngineState state() const noexcept
   { return _state; }
 
-  /** @return Set of all subscribed handlers */
+  /** @return Set of all subscribed handlers and registered targets */
   std::set<EventHandler*> getAllHandlers() const;
 
 private:
@@ -140,8 +485,369 @@ private:
 
   EventQueue _schedule;     ///< Simulation event schedule
 
-  std::set<EventHandler*> _globalHandlers;                      ///< Handlers subscribed to all events
-  std::map<EventType, std::set<EventHandler*>> _typeHandlers;   ///< Event handlers subscribed to specific event types
+  /**
+   * @brief  Process events until the schedule is empty or a stop condition is met
+   * @param stop  Called with the number of events processed before each event, returns true to stop
+   * @param observe  Called with each event after dispatch
+   * @return Number of events processed
+   */
+  template<typename Stop, typename Observe>
+  size_t runLoop(Stop stop, Observe observe);
+
+  /** @brief  Marks the simulation as dispatching for the lifetime of the scope, so subscription changes are queued */
+  class DispatchScope
+  {
+  public:
+    explicit DispatchScope(bool& dispatching) noexcept :
+      _dispatching(dispatching)
+    { _dispatching = true; }
+
+    ~DispatchScope()
+    { _dispatching = false; }
+
+  private:
+    bool& _dispatching;   ///< Dispatching flag of the simulation
+  };
+
+  /** @brief  Apply the subscription changes queued while dispatching */
+  void applyPendingChanges();
+
+  /** @brief  Update the dispatch table after the global handlers or their priorities changed */
+  void globalChanged();
+
+  /**
+   * @brief  Update the dispatch table after the handlers of an event type changed
+   * @param evtType  Event type
+   */
+  void typeChanged(const EventType evtType);
+
+  /**
+   * @param evt  Event addressed to a handler
+   * @return Handler the event is addressed to, null if it has been unsubscribed
+   * @throws std::runtime_error if the target is not registered
+   */
+  inline EventHandler* targetOf(const Event& evt) const
+  {
+    if(evt.target() > _targets.size())
+    {
+      throw std::runtime_error("Event target is not registered");
+    }
+
+    return _targets[evt.target() - 1];
+  }
+
+  /**
+   * @param evtType  Event type
+   * @return Handlers to call for an event of the type, resolving type filters if the type is not in the table
+   */
+  inline DispatchTable::Handlers handlersFor(const EventType evtType)
+  {
+    // Only types selected by a filter are added to the table, others fall back to the global handlers
+    if(!_filters.empty() && !_dispatch.resolved(evtType) && filtered(evtType))
+    {
+      _dispatch.resolve(evtType, typeDispatchOrder(evtType));
+    }
+
+    return _dispatch.find(evtType);
+  }
+
+  /**
+   * @brief  Pass an event to all handlers subscribed to it
+   * @param evt  Event to dispatch
+   */
+  inline void dispatch(const Event& evt)
+  {
+    {
+      DispatchScope scope{_dispatching};
+
+      // Addressed events bypass the subscriptions
+      if(evt.target() != Event::NoTarget)
+      {
+        EventHandler* target = targetOf(evt);
+        if(target)
+        {
+          target->handleEvent(*this, evt);
+        }
+      }
+      else
+      {
+        // Pass event to all global handlers, then to all handlers subscribed to the event type
+        const auto handlers = handlersFor(evt.type());
+        for(auto handler : handlers)
+        {
+          handler->handleEvent(*this, evt);
+        }
+
+        // Then to the handler owning the event type and tag, unless it already had the event
+        if(!_keyedHandlers.empty())
+        {
+          auto it = _keyedHandlers.find(SubscriptionKey(evt.type(), evt.tag()));
+          if((it != _keyedHandlers.cend()) && !it->second.typed)
+          {
+            it->second.handler->handleEvent(*this, evt);
+          }
+        }
+      }
+    }
+
+    if(!_pendingChanges.empty())
+    {
+      applyPendingChanges();
+    }
+  }
+
+  /**
+   * @brief  Pass a batch of events of one type to all handlers subscribed to them, or to their target
+   * @param events  Events to dispatch, all with the same type and target
+   */
+  inline void dispatchBatch(const EventSpan& events)
+  {
+    {
+      DispatchScope scope{_dispatching};
+
+      if(events[0].target() != Event::NoTarget)
+      {
+        EventHandler* target = targetOf(events[0]);
+        if(target)
+        {
+          target->handleEvents(*this, events);
+        }
+      }
+      else
+      {
+        const auto handlers = handlersFor(events[0].type());
+        for(auto handler : handlers)
+        {
+          handler->handleEvents(*this, events);
+        }
+
+        if(!_keyedHandlers.empty())
+        {
+          dispatchKeyedBatch(events);
+        }
+      }
+    }
+
+    if(!_pendingChanges.empty())
+    {
+      applyPendingChanges();
+    }
+  }
+
+  /**
+   * @brief  Pass each run of events with the same tag in a batch to the handler owning the type and tag
+   *
+   * Owners that are also subscribed to the type already had the batch and are skipped
+   *
+   * @param events  Events to dispatch, all of the same type
+   */
+  void dispatchKeyedBatch(const EventSpan& events);
+
+  /**
+   * @param evtType  Event type
+   * @param evtTag  Event tag
+   * @return Key of the keyed subscription to the type and tag
+   */
+  static inline uint64_t SubscriptionKey(const EventType evtType, const EventTag evtTag) noexcept
+  { return (((uint64_t)evtType << 32) | evtTag); }
+
+  /**
+   * @param handlers  Handlers in subscription order
+   * @return Handlers in dispatch order
+   */
+  std::vector<EventHandler*> dispatchOrder(const std::vector<EventHandler*>& handlers) const;
+
+  /**
+   * @param evtType  Event type
+   * @return Handlers subscribed to the type or matching it through a type filter, in dispatch order
+   */
+  std::vector<EventHandler*> typeDispatchOrder(const EventType evtType) const;
+
+  /** @brief  Compile the subscriptions into the dispatch table */
+  void compileDispatch();
+
+  /** @return All subscribed handlers in dispatch order, each listed once */
+  std::vector<EventHandler*> orderedHandlers() const;
+
+  std::vector<EventHandler*> _globalHandlers;                       ///< Handlers subscribed to all events, in subscription order
+  std::map<EventType, std::vector<EventHandler*>> _typeHandlers;    ///< Event handlers subscribed to specific event types, in subscription order
+  std::unordered_map<EventHandler*, HandlerPriority> _priorities;    ///< Dispatch priorities of handlers not at priority 0
+  /** @brief  Subscription to the event types in a range whose bits under a mask equal a value */
+  struct TypeFilter
+  {
+    EventHandler* handler;   ///< Subscribed handler
+    EventType first;         ///< First type of the range
+    EventType last;          ///< Last type of the range
+    EventType mask;          ///< Bits of the type that select the category
+    EventType value;         ///< Value of the selected bits
+
+    /**
+     * @param evtType  Event type
+     * @return True if the filter selects the type
+     */
+    inline bool matches(const EventType evtType) const noexcept
+    { return ((first <= evtType) && (evtType <= last) && ((evtType & mask) == value)); }
+
+    inline bool operator == (const TypeFilter& rhs) const noexcept
+    {
+      return ((handler == rhs.handler) && (first == rhs.first) && (last == rhs.last) &&
+        (mask == rhs.mask) && (value == rhs.value));
+    }
+  };
+
+  /**
+   * @param evtType  Event type
+   * @return True if any type filter selects the type
+   */
+  inline bool filtered(const EventType evtType) const noexcept
+  {
+    for(const auto& filter : _filters)
+    {
+      if(filter.matches(evtType))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief  Add a type filter subscription
+   * @param filter  Filter to add
+   * @throws std::invalid_argument if the filter handler is null
+   */
+  void addFilter(const TypeFilter& filter);
+
+  /**
+   * @brief  Update the dispatch table after a type filter was added or removed, or its handler's priority changed
+   * @param filter  Type filter
+   */
+  void filterChanged(const TypeFilter& filter);
+
+  /**
+   * @brief  Remove the type filters of a handler
+   * @param handler  Event handler
+   * @return Filters removed
+   */
+  std::vector<TypeFilter> eraseFilters(EventHandler* handler);
+
+  /**
+   * @brief  Remove a handler from the handlers subscribed to an event type
+   * @param handler  Event handler
+   * @param evtType  Event type
+   */
+  void eraseTypeHandler(EventHandler* handler, const EventType evtType);
+
+  /** @brief  Handler owning an event type and tag */
+  struct KeyedHandler
+  {
+    EventHandler* handler;   ///< Owning handler
+    bool typed;              ///< True if the handler is also subscribed to the event type, so it has the event already
+  };
+
+  /** @brief  Subscriptions of one handler, indexed so the handler can be removed without searching the others */
+  struct Subscriptions
+  {
+    bool global;                     ///< True if subscribed to all events
+    std::vector<EventType> types;    ///< Event types subscribed to
+    std::vector<uint64_t> keys;      ///< Keys of the event types and tags owned
+    size_t filters;                  ///< Number of type filters
+    HandlerId target;                ///< Id as a target, NoTarget if not registered
+
+    /** @return True if the handler has no subscriptions and is not registered */
+    inline bool empty() const noexcept
+    { return (!global && types.empty() && keys.empty() && (filters == 0) && (target == Event::NoTarget)); }
+  };
+
+  /**
+   * @brief  Update whether the handler owning each of its keys is also subscribed to the key's event type
+   *
+   * Called when the type subscriptions or filters of a handler change, so dispatch
+   * does not have to look for the owner in the handlers of the type.
+   *
+   * @param handler  Event handler
+   * @param subscriptions  Subscriptions of the handler
+   */
+  void keyedChanged(EventHandler* handler, const Subscriptions& subscriptions);
+
+  /**
+   * @param handler  Event handler
+   * @param subscriptions  Subscriptions of the handler
+   * @param evtType  Event type
+   * @return True if the handler is subscribed to the type or to a filter selecting it
+   */
+  bool subscribedTo(EventHandler* handler, const Subscriptions& subscriptions, const EventType evtType) const;
+
+  /**
+   * @brief  Find or add the subscriptions of a handler
+   * @param handler  Event handler
+   * @param joined  Set to true if the handler had no subscriptions
+   * @return Subscriptions of the handler
+   */
+  Subscriptions& subscriptionsOf(EventHandler* handler, bool& joined);
+
+  /**
+   * @brief  Initialize a handler that joined the simulation, if it is Running
+   * @param handler  Event handler
+   */
+  void join(EventHandler* handler);
+
+  /**
+   * @brief  Finalize a handler that left the simulation, if it is Running
+   * @param handler  Event handler
+   */
+  void leave(EventHandler* handler);
+
+  /** @brief  Subscription call made while dispatching */
+  enum class ChangeOp : uint8_t
+  {
+    Subscribe,          ///< subscribe to all events
+    SubscribeType,      ///< subscribe to an event type
+    SubscribeKey,       ///< subscribe to an event type and tag
+    AddFilter,          ///< subscribe to a range or mask
+    Unsubscribe,        ///< unsubscribe from all events
+    UnsubscribeType,    ///< unsubscribe from an event type
+    SetPriority,        ///< set the handler priority
+    Initialize          ///< initialize a handler registered as a target
+  };
+
+  /** @brief  Subscription change queued while dispatching, replayed once the event has reached all its handlers */
+  struct PendingChange
+  {
+    ChangeOp op;                 ///< Call to replay
+    EventHandler* handler;       ///< Event handler
+    EventType type;              ///< Event type
+    EventTag tag;                ///< Event tag
+    HandlerPriority priority;    ///< Dispatch priority
+    TypeFilter filter;           ///< Type filter to add
+  };
+
+  /**
+   * @brief  Queue a subscription change made while dispatching
+   * @param op  Call to replay
+   * @param handler  Event handler
+   * @param evtType  Event type
+   * @param evtTag  Event tag
+   * @param priority  Dispatch priority
+   */
+  inline void queueChange(const ChangeOp op, EventHandler* handler, const EventType evtType = 0,
+    const EventTag evtTag = 0, const HandlerPriority priority = 0)
+  { _pendingChanges.push_back(PendingChange{op, handler, evtType, evtTag, priority, TypeFilter{handler, 0, 0, 0, 0}}); }
+
+  std::vector<TypeFilter> _filters;                                  ///< Handlers subscribed to type ranges and masks, in subscription order
+  std::vector<EventHandler*> _targets;                               ///< Registered targets, indexed by id less one
+  std::unordered_map<uint64_t, KeyedHandler> _keyedHandlers;        ///< Handlers owning specific event types and tags, by subscription key
+  std::unordered_map<EventHandler*, Subscriptions> _subscriptions;   ///< Subscriptions of each subscribed or registered handler
+
+  DispatchTable _dispatch;    ///< Handlers to call for each event type, compiled from the subscriptions
+  bool _dispatchStale;        ///< True until the subscriptions are compiled into the dispatch table by initialize
+  bool _dispatching;          ///< True while an event is being passed to handlers
+
+  std::vector<PendingChange> _pendingChanges;   ///< Subscription changes made while dispatching, in call order, kept to reuse its storage
+  std::unordered_map<uint64_t, EventHandler*> _pendingKeys;   ///< Owners of the keyed subscriptions queued while dispatching
+
+  std::vector<Event> _batch;  ///< Events of the batch being processed, kept to reuse its storage
 };
 
 /**
@@ -0,0 +1,49 @@
+#ifndef __DES_SORTEDARRAYBACKEND_H__
+#define __DES_SORTEDARRAYBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include <vector>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend storing events in a sorted array
+ *
+ *  Events are kept sorted with the earliest event at the back, so removal is O(1)
+ *  and insert is a binary search followed by an O(n) shift.  With few events
+ *  the whole array fits in a handful of cache lines and this beats any linked or
+ *  bucketed structure.
+ */
+class SortedArrayBackend : public QueueBackend
+{
+public:
+  SortedArrayBackend();
+  ~SortedArrayBackend();
+
+  using QueueBackend::insert;
+  void insert(const Event& e, const EventKey& key) override;
+  void appendUnordered(const Event& e, const EventKey& key) override;
+  void restoreOrder(const size_t appended) override;
+  void reserve(const size_t count) override;
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _events.size(); }
+
+private:
+  std::vector<KeyedEvent> _events;    ///< Events sorted with the earliest event at the back
+};
+
+/** @} */
+} // End namespace
+
+#endif
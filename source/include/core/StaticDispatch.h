@@ -0,0 +1,297 @@
+#ifndef __DES_STATICDISPATCH_H__
+#define __DES_STATICDISPATCH_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "DispatchTable.h"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+namespace detail
+{
+  /** @brief  Index of a type in a list of types, undefined if the type is not in the list */
+  template<typename T, typename... Ts>
+  struct IndexOf;
+
+  template<typename T, typename... Ts>
+  struct IndexOf<T, T, Ts...>
+  {
+    static constexpr uint32_t value = 0;
+  };
+
+  template<typename T, typename U, typename... Ts>
+  struct IndexOf<T, U, Ts...>
+  {
+    static constexpr uint32_t value = 1 + IndexOf<T, Ts...>::value;
+  };
+
+  /** @brief  Call a visitor with a handler whose type is given by its index in a list of types */
+  template<uint32_t Index, typename... Ts>
+  struct Visit;
+
+  template<uint32_t Index>
+  struct Visit<Index>
+  {
+    template<typename Visitor>
+    static inline void Call(const uint32_t, void*, Visitor&) noexcept
+    {}
+  };
+
+  template<uint32_t Index, typename T, typename... Ts>
+  struct Visit<Index, T, Ts...>
+  {
+    template<typename Visitor>
+    static inline void Call(const uint32_t kind, void* handler, Visitor& visitor)
+    {
+      if(kind == Index)
+      {
+        visitor(*static_cast<T*>(handler));
+      }
+      else
+      {
+        Visit<Index + 1, Ts...>::Call(kind, handler, visitor);
+      }
+    }
+  };
+}
+
+/**
+ * @brief  Dispatch policy calling handlers of types known at compile time without virtual calls
+ *
+ *  Handlers are stored as a pointer tagged with the index of their type in the
+ *  handler type list, and calls are resolved by comparing the tag against each
+ *  type in turn, so the compiler sees the concrete handler type at every call and
+ *  can inline handleEvent into the dispatch loop.  Handler types need no common
+ *  base class, only non-virtual initialize, finalize and handleEvent members taking
+ *  the engine type.
+ *
+ *  Subscriptions behave as in SimEngine: handlers receive events in subscription
+ *  order, global handlers before type handlers, and subscribing a handler to all
+ *  events removes its type subscriptions and vice versa.  There are no registered
+ *  targets, so events are dispatched by type only and BasicSimEngine rejects
+ *  events addressed to a handler.
+ *
+ * @tparam Handlers  Types of the handlers that can be subscribed
+ */
+template<typename... Handlers>
+class StaticDispatch
+{
+public:
+  StaticDispatch() :
+    _globalHandlers{},
+    _typeHandlers{},
+    _table{},
+    _stale{true}
+  {}
+
+  /**
+   * @brief  Subscribe a handler to all events
+   * @param handler  Handler to subscribe, its type must be one of the handler types
+   * @throws std::invalid_argument if handler is null
+   */
+  template<typename Handler>
+  void subscribe(Handler* handler)
+  {
+    const Entry entry = MakeEntry(handler);
+
+    // Don't double-subscribe handler
+    for(auto& it : _typeHandlers)
+    {
+      auto& handlers = it.second;
+      handlers.erase(std::remove(handlers.begin(), handlers.end(), entry), handlers.end());
+    }
+
+    if(std::find(_globalHandlers.cbegin(), _globalHandlers.cend(), entry) == _globalHandlers.cend())
+    {
+      _globalHandlers.push_back(entry);
+    }
+
+    _stale = true;
+  }
+
+  /**
+   * @brief  Subscribe a handler to a specific event type
+   * @param handler  Handler to subscribe, its type must be one of the handler types
+   * @param evtType  Event type to subscribe to
+   * @throws std::invalid_argument if handler is null
+   */
+  template<typename Handler>
+  void subscribe(Handler* handler, const EventType evtType)
+  {
+    const Entry entry = MakeEntry(handler);
+
+    // Don't double-subscribe handler
+    _globalHandlers.erase(std::remove(_globalHandlers.begin(), _globalHandlers.end(), entry), _globalHandlers.end());
+
+    auto& handlers = _typeHandlers[evtType];
+    if(std::find(handlers.cbegin(), handlers.cend(), entry) == handlers.cend())
+    {
+      handlers.push_back(entry);
+    }
+
+    _stale = true;
+  }
+
+  /**
+   * @brief  Call initialize on all subscribed handlers, then compile the subscriptions
+   * @param sim  Engine passed to the handlers
+   */
+  template<typename Engine>
+  void initialize(Engine& sim)
+  {
+    InitializeVisitor<Engine> visitor{sim};
+    forEachHandler(visitor);
+
+    compile();
+  }
+
+  /**
+   * @brief  Call finalize on all subscribed handlers
+   * @param sim  Engine passed to the handlers
+   */
+  template<typename Engine>
+  void finalize(Engine& sim)
+  {
+    FinalizeVisitor<Engine> visitor{sim};
+    forEachHandler(visitor);
+  }
+
+  /**
+   * @brief  Pass an event to all handlers subscribed to it
+   * @param sim  Engine passed to the handlers
+   * @param evt  Event to dispatch
+   */
+  template<typename Engine>
+  inline void dispatch(Engine& sim, const Event& evt)
+  {
+    if(_stale)
+    {
+      compile();
+    }
+
+    HandleVisitor<Engine> visitor{sim, evt};
+    for(const auto& entry : _table.find(evt.type()))
+    {
+      detail::Visit<0, Handlers...>::Call(entry.kind, entry.handler, visitor);
+    }
+  }
+
+private:
+  /** @brief  Handler pointer tagged with the index of its type */
+  struct Entry
+  {
+    void* handler;    ///< Handler
+    uint32_t kind;    ///< Index of the handler type in Handlers
+
+    inline bool operator == (const Entry& rhs) const noexcept
+    { return (handler == rhs.handler); }
+  };
+
+  /** @brief  Visitor calling handleEvent */
+  template<typename Engine>
+  struct HandleVisitor
+  {
+    Engine& sim;        ///< Engine passed to the handler
+    const Event& evt;   ///< Event passed to the handler
+
+    template<typename Handler>
+    inline void operator () (Handler& handler) const
+    { handler.handleEvent(sim, evt); }
+  };
+
+  /** @brief  Visitor calling initialize */
+  template<typename Engine>
+  struct InitializeVisitor
+  {
+    Engine& sim;   ///< Engine passed to the handler
+
+    template<typename Handler>
+    inline void operator () (Handler& handler) const
+    { handler.initialize(sim); }
+  };
+
+  /** @brief  Visitor calling finalize */
+  template<typename Engine>
+  struct FinalizeVisitor
+  {
+    Engine& sim;   ///< Engine passed to the handler
+
+    template<typename Handler>
+    inline void operator () (Handler& handler) const
+    { handler.finalize(sim); }
+  };
+
+  /**
+   * @param handler  Handler to tag
+   * @return  Handler tagged with the index of its type
+   * @throws std::invalid_argument if handler is null
+   */
+  template<typename Handler>
+  static Entry MakeEntry(Handler* handler)
+  {
+    if(!handler)
+    {
+      throw std::invalid_argument("Handler is null");
+    }
+
+    return Entry{handler, detail::IndexOf<Handler, Handlers...>::value};
+  }
+
+  /**
+   * @brief  Call a visitor once with each subscribed handler, global handlers first
+   * @param visitor  Visitor to call
+   */
+  template<typename Visitor>
+  void forEachHandler(Visitor& visitor)
+  {
+    std::vector<Entry> handlers{_globalHandlers};
+    std::unordered_set<void*> listed{};
+    for(const auto& entry : _globalHandlers)
+    {
+      listed.insert(entry.handler);
+    }
+
+    for(const auto& it : _typeHandlers)
+    {
+      for(const auto& entry : it.second)
+      {
+        if(listed.insert(entry.handler).second)
+        {
+          handlers.push_back(entry);
+        }
+      }
+    }
+
+    for(const auto& entry : handlers)
+    {
+      detail::Visit<0, Handlers...>::Call(entry.kind, entry.handler, visitor);
+    }
+  }
+
+  /** @brief  Compile the subscriptions into the dispatch table */
+  void compile()
+  {
+    _table.compile(_globalHandlers, _typeHandlers);
+    _stale = false;
+  }
+
+  std::vector<Entry> _globalHandlers;                     ///< Handlers subscribed to all events, in subscription order
+  std::map<EventType, std::vector<Entry>> _typeHandlers;  ///< Handlers subscribed to specific event types, in subscription order
+  BasicDispatchTable<Entry> _table;                       ///< Handlers to call for each event type
+  bool _stale;                                            ///< True if subscriptions changed since the table was compiled
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef __DES_TIMINGWHEELBACKEND_H__
+#define __DES_TIMINGWHEELBACKEND_H__
+
+#include "DESCommon.h"
+#include "Event.h"
+#include "EventKey.h"
+#include "QueueBackend.h"
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+namespace des
+{
+/** @addtogroup Core
+* @{
+*/
+
+/**
+ * @brief  Queue backend storing events in a hierarchical timing wheel
+ *
+ *  Level 0 of the wheel has one slot per tick for the 256 ticks following the
+ *  current wheel time, and each higher level has slots 256 times as wide.  Events
+ *  are appended to the slot of the lowest level that can hold them, so events
+ *  scheduled a short delay ahead are inserted and removed in O(1).  When the
+ *  lower levels run empty the next occupied slot of a higher level is cascaded
+ *  down into the lower levels.  Eight levels cover the full range of SimTime.
+ *
+ *  Events earlier than the current wheel time are still accepted and are returned
+ *  first, so causality violations can be detected by the caller.  A level 0 slot
+ *  holds events of a single time, kept as a heap so they are returned in
+ *  priority and insertion order.
+ */
+class TimingWheelBackend : public QueueBackend
+{
+public:
+  TimingWheelBackend();
+  ~TimingWheelBackend();
+
+  using QueueBackend::insert;
+  void insert(const Event& e, const EventKey& key) override;
+  Event getNext() override;
+  const Event& peekNext() const override;
+  EventKey peekKey() const override;
+
+  inline size_t size() const noexcept override
+  { return _size; }
+
+private:
+  static constexpr unsigned SlotBits = 8;                           ///< Number of time bits resolved by each level
+  static constexpr size_t NumSlots = (size_t)1 << SlotBits;         ///< Number of slots in each level
+  static constexpr size_t NumLevels = std::numeric_limits<SimTime>::digits / SlotBits;   ///< Number of levels
+  static constexpr size_t WordBits = std::numeric_limits<uint64_t>::digits;             ///< Number of bits in an occupancy word
+  static constexpr size_t NumWords = NumSlots / WordBits;           ///< Number of occupancy words in each level
+
+  /**
+   * @brief  Get the wheel level an event time belongs in
+   * @param t  Event time, no earlier than the wheel time
+   * @param now  Current wheel time
+   * @return  Index of the highest slot-sized digit in which the times differ
+   */
+  static size_t LevelIndex(const SimTime t, const SimTime now) noexcept;
+
+  /**
+   * @brief  Get the slot an event time belongs in
+   * @param t  Event time
+   * @param level  Wheel level
+   * @return  Slot index within the level
+   */
+  static inline size_t SlotIndex(const SimTime t, const size_t level) noexcept
+  { return (size_t)((t >> (level * SlotBits)) & (NumSlots - 1)); }
+
+  /**
+   * @brief  Append an event to its slot relative to the current wheel time
+   * @param e  Event to place, no earlier than the wheel time
+   */
+  void place(const KeyedEvent& e) const;
+
+  /**
+   * @brief  Find the first occupied slot of a level at or after a given slot
+   * @param level  Wheel level
+   * @param from  First slot to check
+   * @return  Index of the occupied slot, or NumSlots if there is none
+   */
+  size_t findSlot(const size_t level, const size_t from) const noexcept;
+
+  /** @brief  Advance the wheel so the next event is in the current level 0 slot or in the early heap */
+  void advance() const;
+
+  mutable std::vector<KeyedEvent> _slots[NumLevels][NumSlots];  ///< Events in each slot of each level, level 0 slots are heaps
+  mutable uint64_t _occupied[NumLevels][NumWords];              ///< Bitmap of non-empty slots in each level
+  mutable SimTime _now;                                         ///< Current wheel time, no later than any event in the wheel
+
+  std::vector<KeyedEvent> _early;   ///< Heap of events inserted before the wheel time
+  size_t _size;                     ///< Number of events held
+};
+
+/** @} */
+} // End namespace
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef __DES_BINARYEVENTFORMAT_H__
+#define __DES_BINARYEVENTFORMAT_H__
+
+#include "DESCommon.h"
+#include <ios>
+
+namespace des
+{
+/** @addtogroup IO
+* @{
+*/
+
+/** @brief  Layouts of binary event records, fields in native byte order */
+enum class BinaryEventFormat
+{
+  V1,   ///< Time, type and tag
+  V2    ///< Time, type, tag, priority and target
+};
+
+/**
+* @param format  Record layout
+* @return  Size in bytes of one event record
+*/
+inline std::streamsize BinaryEventSize(const BinaryEventFormat format) noexcept
+{
+  return sizeof(SimTime) + sizeof(EventType) + sizeof(EventTag) +
+    ((format == BinaryEventFormat::V2) ? (sizeof(EventPriority) + sizeof(HandlerId)) : 0);
+}
+
+/** @} */
+} // End namespace
+
+#endif
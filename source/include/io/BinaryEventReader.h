@@ -4,6 +4,7 @@
 #include "DESCommon.h"
 #include "core/Event.h"
 #include "io/EventReader.h"
+#include "io/BinaryEventFormat.h"
 #include <istream>
 
 namespace des
@@ -18,17 +19,26 @@ class BinaryEventReader : public EventReader
 public:
   /**
   * @param buffer  Pointer to stream buffer to read from
+  * @param format  Record layout to read
   */
-  BinaryEventReader(std::streambuf* buffer);
+  BinaryEventReader(std::streambuf* buffer, const BinaryEventFormat format = BinaryEventFormat::V1);
 
   /**
   * @param str  Stream to read from
+  * @param format  Record layout to read
   */
-  BinaryEventReader(std::istream& str);
+  BinaryEventReader(std::istream& str, const BinaryEventFormat format = BinaryEventFormat::V1);
 
   ~BinaryEventReader();
 
   Event read() override;
+
+  /** @return  Record layout read */
+  inline BinaryEventFormat format() const noexcept
+  { return _format; }
+
+private:
+  BinaryEventFormat _format;    ///< Record layout read
 };
 
 /** @} */
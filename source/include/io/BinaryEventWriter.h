@@ -4,6 +4,7 @@
 #include "DESCommon.h"
 #include "core/Event.h"
 #include "io/EventWriter.h"
+#include "io/BinaryEventFormat.h"
 #include <ostream>
 
 namespace des
@@ -12,23 +13,42 @@ namespace des
 * @{
 */
 
-/** @brief  Class for writing events to binary format */
+/**
+ * @brief  Class for writing events to binary format
+ *
+ *  The V1 layout has no room for priorities or targets, so writing an event with
+ *  either set throws rather than losing them.
+ */
 class BinaryEventWriter : public EventWriter
 {
 public:
   /**
   * @param buffer  Pointer to stream buffer to write to
+  * @param format  Record layout to write
   */
-  BinaryEventWriter(std::streambuf* buffer);
+  BinaryEventWriter(std::streambuf* buffer, const BinaryEventFormat format = BinaryEventFormat::V1);
 
   /**
   * @param str  Stream to write to
+  * @param format  Record layout to write
   */
-  BinaryEventWriter(std::ostream& str);
+  BinaryEventWriter(std::ostream& str, const BinaryEventFormat format = BinaryEventFormat::V1);
 
   ~BinaryEventWriter();
 
+  /**
+  * @brief  Write the given event to the stream
+  * @param e  Event to write
+  * @throws  EventWriteException if write fails, or if the V1 layout can't hold the event priority or target
+  */
   void write(const Event& e) override;
+
+  /** @return  Record layout written */
+  inline BinaryEventFormat format() const noexcept
+  { return _format; }
+
+private:
+  BinaryEventFormat _format;    ///< Record layout written
 };
 
 /** @} */
@@ -47,10 +47,13 @@ protected:
   * @param t  Event occurence time
   * @param n  Event type
   * @param g  Event tag
+  * @param p  Event priority
+  * @param h  Event target handler
   * @return  Constructed event
   */
-  inline static Event CreateEvent(SimTime t, EventType n, EventTag g)
-  { return Event{t, n, g}; }
+  inline static Event CreateEvent(SimTime t, EventType n, EventTag g, EventPriority p = 0,
+    HandlerId h = Event::NoTarget)
+  { return Event{t, n, g, p, h}; }
 
   std::istream _in;     ///< Input stream for reading from buffer
 };
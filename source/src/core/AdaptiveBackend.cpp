@@ -0,0 +1,163 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/AdaptiveBackend.h"
+#include "core/SortedArrayBackend.h"
+#include "core/DaryHeapBackend.h"
+#include "core/CalendarQueueBackend.h"
+#include <stdexcept>
+
+namespace des
+{
+
+constexpr size_t AdaptiveBackend::SmallLimit;
+constexpr size_t AdaptiveBackend::BucketLimit;
+constexpr size_t AdaptiveBackend::SampleInterval;
+constexpr double AdaptiveBackend::MaxVariation;
+
+AdaptiveBackend::AdaptiveBackend() :
+  QueueBackend{},
+  _backend{CreateBackend(Structure::SortedArray)},
+  _structure{Structure::SortedArray},
+  _lastTime{0},
+  _samples{0},
+  _sum{0},
+  _sumSquares{0}
+{
+}
+
+AdaptiveBackend::~AdaptiveBackend()
+{
+}
+
+std::unique_ptr<QueueBackend> AdaptiveBackend::CreateBackend(const Structure structure)
+{
+  switch(structure)
+  {
+    case Structure::SortedArray:
+      return std::unique_ptr<QueueBackend>{new SortedArrayBackend{}};
+
+    case Structure::Heap:
+      return std::unique_ptr<QueueBackend>{new QuaternaryHeapBackend{}};
+
+    case Structure::Buckets:
+      return std::unique_ptr<QueueBackend>{new CalendarQueueBackend{}};
+
+    default:
+      throw std::invalid_argument("Unknown structure");
+  }
+}
+
+void AdaptiveBackend::insert(const Event& e, const EventKey& key)
+{
+  _backend->insert(e, key);
+  checkGrowth();
+}
+
+void AdaptiveBackend::appendUnordered(const Event& e, const EventKey& key)
+{
+  _backend->appendUnordered(e, key);
+}
+
+void AdaptiveBackend::restoreOrder(const size_t appended)
+{
+  _backend->restoreOrder(appended);
+  checkGrowth();
+}
+
+void AdaptiveBackend::reserve(const size_t count)
+{
+  _backend->reserve(count);
+}
+
+Event AdaptiveBackend::getNext()
+{
+  Event e = _backend->getNext();
+
+  // Sample the increment, ignoring events that precede the last removed event
+  if(e.time() >= _lastTime)
+  {
+    const double increment = (double)(e.time() - _lastTime);
+    _sum += increment;
+    _sumSquares += increment * increment;
+    _lastTime = e.time();
+  }
+
+  if(++_samples >= SampleInterval)
+  {
+    const Structure structure = select();
+    if(structure != _structure)
+    {
+      migrate(structure);
+    }
+
+    _samples = 0;
+    _sum = 0;
+    _sumSquares = 0;
+  }
+
+  return e;
+}
+
+const Event& AdaptiveBackend::peekNext() const
+{
+  return _backend->peekNext();
+}
+
+EventKey AdaptiveBackend::peekKey() const
+{
+  return _backend->peekKey();
+}
+
+AdaptiveBackend::Structure AdaptiveBackend::select() const noexcept
+{
+  // Limits are doubled or halved when leaving the current structure
+  const size_t count = size();
+  const size_t smallLimit = (_structure == Structure::SortedArray) ? (2 * SmallLimit) : SmallLimit;
+  const size_t bucketLimit = (_structure == Structure::Buckets) ? (BucketLimit / 2) : BucketLimit;
+
+  if(count <= smallLimit)
+  {
+    return Structure::SortedArray;
+  }
+
+  // Buckets suit increments of similar size, irregular increments leave most buckets empty
+  if((count >= bucketLimit) && (_samples > 0))
+  {
+    const double mean = _sum / _samples;
+    const double variance = (_sumSquares / _samples) - (mean * mean);
+    if((mean > 0) && (variance <= MaxVariation * MaxVariation * mean * mean))
+    {
+      return Structure::Buckets;
+    }
+  }
+
+  return Structure::Heap;
+}
+
+void AdaptiveBackend::migrate(const Structure structure)
+{
+  std::unique_ptr<QueueBackend> backend = CreateBackend(structure);
+
+  // Events are moved in queue order with their keys
+  const size_t count = _backend->size();
+  backend->reserve(count);
+  while(_backend->size() > 0)
+  {
+    const EventKey key = _backend->peekKey();
+    backend->appendUnordered(_backend->getNext(), key);
+  }
+  backend->restoreOrder(count);
+
+  _backend = std::move(backend);
+  _structure = structure;
+}
+
+void AdaptiveBackend::checkGrowth()
+{
+  if((_structure == Structure::SortedArray) && (size() > 2 * SmallLimit))
+  {
+    migrate(Structure::Heap);
+  }
+}
+
+} // End namespace
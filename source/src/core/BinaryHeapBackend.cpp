@@ -0,0 +1,263 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/BinaryHeapBackend.h"
+#include <cassert>
+
+namespace des
+{
+
+constexpr uint32_t BinaryHeapBackend::NotQueued;
+
+BinaryHeapBackend::BinaryHeapBackend() :
+  QueueBackend{},
+  _keys{},
+  _heapSlots{},
+  _slots{},
+  _freeSlots{}
+{
+}
+
+BinaryHeapBackend::~BinaryHeapBackend()
+{
+}
+
+void BinaryHeapBackend::insert(const Event& e, const EventKey& key)
+{
+  insertTracked(e, key);
+}
+
+void BinaryHeapBackend::appendUnordered(const Event& e, const EventKey& key)
+{
+  append(e, key);
+}
+
+void BinaryHeapBackend::restoreOrder(const size_t appended)
+{
+  const size_t count = _keys.size();
+  const size_t ordered = count - appended;
+
+  // Sift up a few appended keys, otherwise rebuild the whole heap bottom-up in linear time
+  if(appended <= ordered / 16)
+  {
+    for(size_t i = ordered; i < count; ++i)
+    {
+      siftUp(i);
+    }
+  }
+  else
+  {
+    for(size_t i = count / 2; i > 0; --i)
+    {
+      siftDown(i - 1);
+    }
+  }
+}
+
+void BinaryHeapBackend::reserve(const size_t count)
+{
+  _keys.reserve(count);
+  _heapSlots.reserve(count);
+  _slots.reserve(count);
+}
+
+uint64_t BinaryHeapBackend::insertTracked(const Event& e, const EventKey& key)
+{
+  const uint32_t slot = append(e, key);
+  siftUp(_keys.size() - 1);
+
+  return ((uint64_t)_slots[slot].generation << 32) | slot;
+}
+
+Event BinaryHeapBackend::getNext()
+{
+  return removeAt(0);
+}
+
+const Event& BinaryHeapBackend::peekNext() const
+{
+  return _slots[_heapSlots.front()].event;
+}
+
+EventKey BinaryHeapBackend::peekKey() const
+{
+  return _keys.front();
+}
+
+bool BinaryHeapBackend::cancel(const uint64_t id)
+{
+  const uint32_t position = locate(id);
+  if(position == NotQueued)
+  {
+    return false;
+  }
+
+  removeAt(position);
+  return true;
+}
+
+bool BinaryHeapBackend::reschedule(const uint64_t id, const SimTime newTime, const uint64_t sequence)
+{
+  const uint32_t position = locate(id);
+  if(position == NotQueued)
+  {
+    return false;
+  }
+
+  // A rescheduled event orders after events already queued for the new time
+  Event& e = _slots[_heapSlots[position]].event;
+  const bool earlier = (newTime < e.time());
+  e = Event{newTime, e.type(), e.tag(), e.priority(), e.target()};
+  _keys[position] = EventKey::Make(e, sequence);
+
+  if(earlier)
+  {
+    siftUp(position);
+  }
+  else
+  {
+    siftDown(position);
+  }
+
+  return true;
+}
+
+bool BinaryHeapBackend::pending(const uint64_t id) const
+{
+  return (locate(id) != NotQueued);
+}
+
+bool BinaryHeapBackend::lookup(const uint64_t id, KeyedEvent& e) const
+{
+  const uint32_t position = locate(id);
+  if(position == NotQueued)
+  {
+    return false;
+  }
+
+  e = KeyedEvent{_keys[position], _slots[_heapSlots[position]].event};
+  return true;
+}
+
+uint32_t BinaryHeapBackend::append(const Event& e, const EventKey& key)
+{
+  // Reuse a released slot if one is available
+  uint32_t slot;
+  if(!_freeSlots.empty())
+  {
+    slot = _freeSlots.back();
+    _freeSlots.pop_back();
+    _slots[slot].event = e;
+  }
+  else
+  {
+    slot = (uint32_t)_slots.size();
+    _slots.push_back(Slot{e, NotQueued, 0});
+  }
+
+  _slots[slot].position = (uint32_t)_keys.size();
+  _keys.push_back(key);
+  _heapSlots.push_back(slot);
+
+  return slot;
+}
+
+uint32_t BinaryHeapBackend::locate(const uint64_t id) const noexcept
+{
+  const uint32_t slot = (uint32_t)id;
+  const uint32_t generation = (uint32_t)(id >> 32);
+
+  if((slot >= _slots.size()) || (_slots[slot].generation != generation))
+  {
+    return NotQueued;
+  }
+
+  return _slots[slot].position;
+}
+
+Event BinaryHeapBackend::removeAt(const size_t position)
+{
+  assert(position < _keys.size());
+
+  // Release the slot so existing identifiers no longer match
+  const uint32_t removed = _heapSlots[position];
+  Slot& slot = _slots[removed];
+  slot.position = NotQueued;
+  ++slot.generation;
+  _freeSlots.push_back(removed);
+
+  // Fill the hole with the last key
+  const EventKey lastKey = _keys.back();
+  const uint32_t lastSlot = _heapSlots.back();
+  _keys.pop_back();
+  _heapSlots.pop_back();
+
+  if(position < _keys.size())
+  {
+    assign(position, lastKey, lastSlot);
+
+    if((position > 0) && (lastKey < _keys[(position - 1) / 2]))
+    {
+      siftUp(position);
+    }
+    else
+    {
+      siftDown(position);
+    }
+  }
+
+  return slot.event;
+}
+
+void BinaryHeapBackend::siftUp(size_t position)
+{
+  const EventKey key = _keys[position];
+  const uint32_t slot = _heapSlots[position];
+
+  while(position > 0)
+  {
+    const size_t parent = (position - 1) / 2;
+    if(!(key < _keys[parent]))
+    {
+      break;
+    }
+
+    assign(position, _keys[parent], _heapSlots[parent]);
+    position = parent;
+  }
+
+  assign(position, key, slot);
+}
+
+void BinaryHeapBackend::siftDown(size_t position)
+{
+  const EventKey key = _keys[position];
+  const uint32_t slot = _heapSlots[position];
+  const size_t count = _keys.size();
+
+  while(true)
+  {
+    size_t child = (2 * position) + 1;
+    if(child >= count)
+    {
+      break;
+    }
+
+    // Select the earlier child
+    if((child + 1 < count) && (_keys[child + 1] < _keys[child]))
+    {
+      ++child;
+    }
+
+    if(!(_keys[child] < key))
+    {
+      break;
+    }
+
+    assign(position, _keys[child], _heapSlots[child]);
+    position = child;
+  }
+
+  assign(position, key, slot);
+}
+
+} // End namespace
@@ -0,0 +1,181 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/CalendarQueueBackend.h"
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+namespace des
+{
+
+constexpr size_t CalendarQueueBackend::MinBuckets;
+constexpr size_t CalendarQueueBackend::SampleSize;
+
+CalendarQueueBackend::CalendarQueueBackend() :
+  QueueBackend{},
+  _buckets(MinBuckets),
+  _mask{MinBuckets - 1},
+  _size{0},
+  _width{1},
+  _bucket{0},
+  _slot{0}
+{
+}
+
+CalendarQueueBackend::~CalendarQueueBackend()
+{
+}
+
+void CalendarQueueBackend::insert(const Event& e, const EventKey& key)
+{
+  const KeyedEvent keyed{key, e};
+  const SimTime slot = e.time() / _width;
+
+  // Never leave an event behind the search position
+  if((_size == 0) || (slot < _slot))
+  {
+    _slot = slot;
+    _bucket = slot & _mask;
+  }
+
+  place(keyed);
+  ++_size;
+
+  if(_size > 2 * _buckets.size())
+  {
+    resize(2 * _buckets.size());
+  }
+}
+
+Event CalendarQueueBackend::getNext()
+{
+  auto& bucket = _buckets[locateNext()];
+
+  Event e = bucket.back().event;
+  bucket.pop_back();
+  --_size;
+
+  if((_buckets.size() > MinBuckets) && (_size < _buckets.size() / 2))
+  {
+    resize(_buckets.size() / 2);
+  }
+
+  return e;
+}
+
+const Event& CalendarQueueBackend::peekNext() const
+{
+  return _buckets[locateNext()].back().event;
+}
+
+EventKey CalendarQueueBackend::peekKey() const
+{
+  return _buckets[locateNext()].back().key;
+}
+
+size_t CalendarQueueBackend::locateNext() const
+{
+  assert(_size > 0);
+
+  // Search one year of buckets for an event in the current time slot
+  for(size_t i = 0; i < _buckets.size(); ++i)
+  {
+    const auto& bucket = _buckets[_bucket];
+    if(!bucket.empty() && (bucket.back().key.time / _width <= _slot))
+    {
+      return _bucket;
+    }
+
+    _bucket = (_bucket + 1) & _mask;
+    ++_slot;
+  }
+
+  // Next event is more than a year away, search all buckets directly
+  size_t found = 0;
+  SimTime earliest = std::numeric_limits<SimTime>::max();
+  for(size_t i = 0; i < _buckets.size(); ++i)
+  {
+    const auto& bucket = _buckets[i];
+    if(!bucket.empty() && (bucket.back().key.time <= earliest))
+    {
+      earliest = bucket.back().key.time;
+      found = i;
+    }
+  }
+
+  _bucket = found;
+  _slot = earliest / _width;
+
+  return found;
+}
+
+void CalendarQueueBackend::resize(size_t bucketCount)
+{
+  // Collect all events
+  std::vector<KeyedEvent> events{};
+  events.reserve(_size);
+  for(const auto& bucket : _buckets)
+  {
+    events.insert(events.end(), bucket.cbegin(), bucket.cend());
+  }
+
+  // Sort the earliest events to sample their separation
+  const size_t sampleCount = std::min(events.size(), SampleSize);
+  std::partial_sort(events.begin(), events.begin() + sampleCount, events.end(),
+    [] (const KeyedEvent& lhs, const KeyedEvent& rhs) { return (lhs.key < rhs.key); });
+
+  if(sampleCount > 1)
+  {
+    // Average separation, ignoring separations more than twice the overall average
+    const SimTime limit = 2 * ((events[sampleCount - 1].key.time - events[0].key.time) / (sampleCount - 1));
+
+    SimTime total = 0;
+    SimTime count = 0;
+    for(size_t i = 1; i < sampleCount; ++i)
+    {
+      SimTime separation = events[i].key.time - events[i - 1].key.time;
+      if(separation <= limit)
+      {
+        total += separation;
+        ++count;
+      }
+    }
+
+    // Keep the current width if all sampled events occur at the same time
+    SimTime average = (count > 0) ? (total / count) : 0;
+    if(average > 0)
+    {
+      _width = (average < std::numeric_limits<SimTime>::max() / 3) ?
+        (3 * average) : std::numeric_limits<SimTime>::max();
+    }
+  }
+
+  // Rebuild buckets
+  _buckets.assign(bucketCount, std::vector<KeyedEvent>{});
+  _mask = bucketCount - 1;
+
+  for(const auto& e : events)
+  {
+    place(e);
+  }
+
+  // Restart search from the earliest event
+  if(!events.empty())
+  {
+    _slot = events[0].key.time / _width;
+    _bucket = _slot & _mask;
+  }
+}
+
+void CalendarQueueBackend::place(const KeyedEvent& e)
+{
+  auto& bucket = _buckets[(e.key.time / _width) & _mask];
+
+  // Buckets are sorted latest first
+  auto it = std::lower_bound(bucket.begin(), bucket.end(), e,
+    [] (const KeyedEvent& lhs, const KeyedEvent& rhs) { return (rhs.key < lhs.key); });
+
+  bucket.insert(it, e);
+}
+
+} // End namespace
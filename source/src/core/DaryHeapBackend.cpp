@@ -0,0 +1,278 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/DaryHeapBackend.h"
+#include <limits>
+
+// AVX2 child selection, enabled when compiling for AVX2 with GCC or Clang (BUILD_WITH_AVX2)
+#if defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__))
+#define DES_DARYHEAP_AVX2
+#include <immintrin.h>
+#endif
+
+namespace des
+{
+
+namespace
+{
+  constexpr SimTime MaxTime = std::numeric_limits<SimTime>::max();
+  constexpr uint64_t MaxOrder = std::numeric_limits<uint64_t>::max();
+
+#if defined(DES_DARYHEAP_AVX2)
+  // Lane-wise unsigned minimum of 64 bit keys, with the sign bits already flipped
+  inline __m256i MinKeys(const __m256i lhs, const __m256i rhs) noexcept
+  { return _mm256_blendv_epi8(lhs, rhs, _mm256_cmpgt_epi64(lhs, rhs)); }
+
+  // Broadcast the minimum of four 64 bit keys to all lanes
+  inline __m256i ReduceMinKeys(__m256i keys) noexcept
+  {
+    keys = MinKeys(keys, _mm256_permute4x64_epi64(keys, _MM_SHUFFLE(2, 3, 0, 1)));
+    return MinKeys(keys, _mm256_permute4x64_epi64(keys, _MM_SHUFFLE(1, 0, 3, 2)));
+  }
+
+  // Load four keys, flipping the sign bits so signed comparisons order them as unsigned
+  inline __m256i LoadKeys(const SimTime* keys) noexcept
+  {
+    return _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys)),
+      _mm256_set1_epi64x(std::numeric_limits<int64_t>::min()));
+  }
+
+  // Bit mask of lanes equal to the minimum
+  inline unsigned MatchKeys(const __m256i keys, const __m256i min) noexcept
+  { return (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(keys, min))); }
+#endif
+}
+
+template<size_t Arity>
+constexpr size_t DaryHeapBackend<Arity>::Root;
+
+template<size_t Arity>
+constexpr size_t DaryHeapBackend<Arity>::CacheLine;
+
+template<size_t Arity>
+DaryHeapBackend<Arity>::DaryHeapBackend() :
+  QueueBackend{},
+  _keys(Arity, MaxTime),
+  _orders(Arity, MaxOrder),
+  _events(Arity, Event{0, 0}),
+  _size{0}
+{
+}
+
+template<size_t Arity>
+DaryHeapBackend<Arity>::~DaryHeapBackend()
+{
+}
+
+#if defined(DES_DARYHEAP_AVX2)
+template<size_t Arity>
+size_t DaryHeapBackend<Arity>::breakTie(const size_t first, unsigned mask) const noexcept
+{
+  // Usually a single child has the earliest time, otherwise take the earliest inserted
+  size_t best = first + __builtin_ctz(mask);
+  for(mask &= mask - 1; mask != 0; mask &= mask - 1)
+  {
+    const size_t child = first + __builtin_ctz(mask);
+    if(_orders[child] < _orders[best])
+    {
+      best = child;
+    }
+  }
+
+  return best;
+}
+#endif
+
+template<>
+size_t DaryHeapBackend<4>::minChild(const size_t first) const noexcept
+{
+#if defined(DES_DARYHEAP_AVX2)
+  const __m256i keys = LoadKeys(&_keys[first]);
+  return breakTie(first, MatchKeys(keys, ReduceMinKeys(keys)));
+#else
+  const size_t a = (key(first + 1) < key(first)) ? 1 : 0;
+  const size_t b = (key(first + 3) < key(first + 2)) ? 3 : 2;
+  return first + ((key(first + b) < key(first + a)) ? b : a);
+#endif
+}
+
+template<>
+size_t DaryHeapBackend<8>::minChild(const size_t first) const noexcept
+{
+#if defined(DES_DARYHEAP_AVX2)
+  const __m256i lo = LoadKeys(&_keys[first]);
+  const __m256i hi = LoadKeys(&_keys[first + 4]);
+  const __m256i min = ReduceMinKeys(MinKeys(lo, hi));
+  return breakTie(first, MatchKeys(lo, min) | (MatchKeys(hi, min) << 4));
+#else
+  const size_t a = (key(first + 1) < key(first)) ? 1 : 0;
+  const size_t b = (key(first + 3) < key(first + 2)) ? 3 : 2;
+  const size_t c = (key(first + 5) < key(first + 4)) ? 5 : 4;
+  const size_t d = (key(first + 7) < key(first + 6)) ? 7 : 6;
+  const size_t ab = (key(first + b) < key(first + a)) ? b : a;
+  const size_t cd = (key(first + d) < key(first + c)) ? d : c;
+  return first + ((key(first + cd) < key(first + ab)) ? cd : ab);
+#endif
+}
+
+template<size_t Arity>
+void DaryHeapBackend<Arity>::insert(const Event& e, const EventKey& key)
+{
+  appendUnordered(e, key);
+  siftUp(Root + _size - 1);
+}
+
+template<size_t Arity>
+void DaryHeapBackend<Arity>::appendUnordered(const Event& e, const EventKey& key)
+{
+  grow();
+  store(Root + _size, key, e);
+  ++_size;
+}
+
+template<size_t Arity>
+void DaryHeapBackend<Arity>::restoreOrder(const size_t appended)
+{
+  const size_t end = Root + _size;
+  const size_t ordered = _size - appended;
+
+  // Sift up a few appended nodes, otherwise rebuild the whole heap bottom-up in linear time
+  if(appended <= ordered / 16)
+  {
+    for(size_t node = end - appended; node < end; ++node)
+    {
+      siftUp(node);
+    }
+  }
+  else if(_size > 1)
+  {
+    for(size_t node = Parent(end - 1); node >= Root; --node)
+    {
+      siftDown(node);
+    }
+  }
+}
+
+template<size_t Arity>
+void DaryHeapBackend<Arity>::reserve(const size_t count)
+{
+  // Round up to whole groups of children
+  const size_t nodes = Root + count;
+  const size_t capacity = ((nodes + Arity - 1) / Arity) * Arity;
+  _keys.reserve(capacity);
+  _orders.reserve(capacity);
+  _events.reserve(capacity);
+}
+
+template<size_t Arity>
+Event DaryHeapBackend<Arity>::getNext()
+{
+  Event next = _events[Root];
+
+  // Remove the last event, to be sifted down from the root
+  --_size;
+  const size_t last = Root + _size;
+  const EventKey lastKey = key(last);
+  _keys[last] = MaxTime;
+  _orders[last] = MaxOrder;
+
+  if(last == Root)
+  {
+    return next;
+  }
+
+  // Sift down, moving the earliest child up into the hole
+  size_t node = Root;
+  size_t first = FirstChild(node);
+  while(first < last)
+  {
+    const size_t child = minChild(first);
+    if(!(key(child) < lastKey))
+    {
+      break;
+    }
+
+    store(node, key(child), _events[child]);
+    node = child;
+    first = FirstChild(node);
+  }
+
+  store(node, lastKey, _events[last]);
+
+  return next;
+}
+
+template<size_t Arity>
+const Event& DaryHeapBackend<Arity>::peekNext() const
+{
+  return _events[Root];
+}
+
+template<size_t Arity>
+EventKey DaryHeapBackend<Arity>::peekKey() const
+{
+  return key(Root);
+}
+
+template<size_t Arity>
+void DaryHeapBackend<Arity>::grow()
+{
+  // Grow by one group of children, unused keys hold the maximum time so they are never selected
+  if(Root + _size >= _keys.size())
+  {
+    _keys.resize(_keys.size() + Arity, MaxTime);
+    _orders.resize(_orders.size() + Arity, MaxOrder);
+    _events.resize(_events.size() + Arity, Event{0, 0});
+  }
+}
+
+template<size_t Arity>
+void DaryHeapBackend<Arity>::siftUp(size_t node)
+{
+  const EventKey nodeKey = key(node);
+  const Event e = _events[node];
+
+  // Move parents down into the hole
+  while(node > Root)
+  {
+    const size_t parent = Parent(node);
+    if(!(nodeKey < key(parent)))
+    {
+      break;
+    }
+
+    store(node, key(parent), _events[parent]);
+    node = parent;
+  }
+
+  store(node, nodeKey, e);
+}
+
+template<size_t Arity>
+void DaryHeapBackend<Arity>::siftDown(size_t node)
+{
+  const EventKey nodeKey = key(node);
+  const Event e = _events[node];
+  const size_t end = Root + _size;
+
+  size_t first = FirstChild(node);
+  while(first < end)
+  {
+    const size_t child = minChild(first);
+    if(!(key(child) < nodeKey))
+    {
+      break;
+    }
+
+    store(node, key(child), _events[child]);
+    node = child;
+    first = FirstChild(node);
+  }
+
+  store(node, nodeKey, e);
+}
+
+template class DaryHeapBackend<4>;
+template class DaryHeapBackend<8>;
+
+} // End namespace
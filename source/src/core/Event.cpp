@@ -4,10 +4,14 @@
 namespace des
 {
 
-Event::Event(const SimTime t, const EventType n, const EventTag g) noexcept :
+constexpr HandlerId Event::NoTarget;
+
+Event::Event(const SimTime t, const EventType n, const EventTag g, const EventPriority p, const HandlerId h) noexcept :
   _time{t},
   _type{n},
-  _tag{g}
+  _tag{g},
+  _priority{p},
+  _target{h}
 {
 }
 
@@ -0,0 +1,23 @@
+#include "DESCommon.h"
+#include "core/EventHandle.h"
+#include "core/EventQueue.h"
+
+namespace des
+{
+
+bool EventHandle::cancel()
+{
+  return (_queue != nullptr) && _queue->cancel(*this);
+}
+
+bool EventHandle::reschedule(const SimTime newTime)
+{
+  return (_queue != nullptr) && _queue->reschedule(*this, newTime);
+}
+
+bool EventHandle::pending() const
+{
+  return (_queue != nullptr) && _queue->pending(*this);
+}
+
+} // End namespace
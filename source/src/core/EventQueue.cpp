@@ -1,45 +1,364 @@
 #include "DESCommon.h"
 #include "core/Event.h"
 #include "core/EventQueue.h"
+#include "core/BinaryHeapBackend.h"
+#include "core/CalendarQueueBackend.h"
+#include "core/RadixHeapBackend.h"
+#include "core/TimingWheelBackend.h"
+#include "core/LadderQueueBackend.h"
+#include "core/DaryHeapBackend.h"
+#include "core/SortedArrayBackend.h"
+#include "core/AdaptiveBackend.h"
+#include "core/PartitionedBackend.h"
 #include <stdexcept>
 
 namespace des
 {
 
-// Sort events such that events with a smaller time are further ahead in the queue
-std::function<bool(const Event&, const Event&)> EventQueue::QueueSorter
-  { [] (const Event& lhs, const Event& rhs) { return (rhs.time() < lhs.time()); } };
-
 EventQueue::EventQueue() :
-  _queue{EventQueue::QueueSorter}
+  _backend{new BinaryHeapBackend{}},
+  _lanes{},
+  _laneSize{0},
+  _sequence{0},
+  _indices{}
 {
 }
 
+EventQueue::EventQueue(const QueueBackendType backendType) :
+  _backend{EventQueue::CreateBackend(backendType)},
+  _lanes{},
+  _laneSize{0},
+  _sequence{0},
+  _indices{}
+{
+}
+
+EventQueue::EventQueue(std::unique_ptr<QueueBackend> backend) :
+  _backend{std::move(backend)},
+  _lanes{},
+  _laneSize{0},
+  _sequence{0},
+  _indices{}
+{
+  if(!_backend)
+  {
+    throw std::invalid_argument("Backend is null");
+  }
+
+  if(_backend->size() != 0)
+  {
+    throw std::invalid_argument("Backend is not empty");
+  }
+}
+
 EventQueue::~EventQueue()
 {
 }
 
+std::unique_ptr<QueueBackend> EventQueue::CreateBackend(const QueueBackendType backendType)
+{
+  switch(backendType)
+  {
+    case QueueBackendType::BinaryHeap:
+      return std::unique_ptr<QueueBackend>{new BinaryHeapBackend{}};
+
+    case QueueBackendType::CalendarQueue:
+      return std::unique_ptr<QueueBackend>{new CalendarQueueBackend{}};
+
+    case QueueBackendType::RadixHeap:
+      return std::unique_ptr<QueueBackend>{new RadixHeapBackend{}};
+
+    case QueueBackendType::TimingWheel:
+      return std::unique_ptr<QueueBackend>{new TimingWheelBackend{}};
+
+    case QueueBackendType::LadderQueue:
+      return std::unique_ptr<QueueBackend>{new LadderQueueBackend{}};
+
+    case QueueBackendType::QuaternaryHeap:
+      return std::unique_ptr<QueueBackend>{new QuaternaryHeapBackend{}};
+
+    case QueueBackendType::OctonaryHeap:
+      return std::unique_ptr<QueueBackend>{new OctonaryHeapBackend{}};
+
+    case QueueBackendType::SortedArray:
+      return std::unique_ptr<QueueBackend>{new SortedArrayBackend{}};
+
+    case QueueBackendType::Adaptive:
+      return std::unique_ptr<QueueBackend>{new AdaptiveBackend{}};
+
+    case QueueBackendType::Partitioned:
+      return std::unique_ptr<QueueBackend>{new PartitionedBackend{}};
+
+    default:
+      throw std::invalid_argument("Unknown backend type");
+  }
+}
+
+bool EventQueue::cancel(const EventHandle& handle)
+{
+  if(handle.queue() != this)
+  {
+    throw std::invalid_argument("Handle does not belong to this queue");
+  }
+
+  if(!_indices)
+  {
+    return _backend->cancel(handle.id());
+  }
+
+  KeyedEvent e{EventKey{0, 0}, Event{0, 0}};
+  if(!_backend->lookup(handle.id(), e))
+  {
+    return false;
+  }
+
+  _backend->cancel(handle.id());
+  unindex(e);
+  return true;
+}
+
+bool EventQueue::reschedule(const EventHandle& handle, const SimTime newTime)
+{
+  if(handle.queue() != this)
+  {
+    throw std::invalid_argument("Handle does not belong to this queue");
+  }
+
+  if(!_indices)
+  {
+    return _backend->reschedule(handle.id(), newTime, EventKey::Next(_sequence));
+  }
+
+  KeyedEvent e{EventKey{0, 0}, Event{0, 0}};
+  if(!_backend->lookup(handle.id(), e))
+  {
+    return false;
+  }
+
+  const uint64_t sequence = EventKey::Next(_sequence);
+  _backend->reschedule(handle.id(), newTime, sequence);
+  unindex(e);
+
+  const Event moved{newTime, e.event.type(), e.event.tag(), e.event.priority(), e.event.target()};
+  index(KeyedEvent{EventKey::Make(moved, sequence), moved});
+  return true;
+}
+
+bool EventQueue::pending(const EventHandle& handle) const
+{
+  if(handle.queue() != this)
+  {
+    throw std::invalid_argument("Handle does not belong to this queue");
+  }
+
+  return _backend->pending(handle.id());
+}
+
 Event EventQueue::getNext()
 {
-  if(_queue.empty())
+  if(empty())
   {
     throw std::runtime_error("Queue is empty");
   }
-  
-  Event e = std::move(const_cast<Event&>(_queue.top()));
-  _queue.pop();
 
-  return e;
+  const size_t next = nextLane();
+  if(next != _lanes.size())
+  {
+    Lane& lane = _lanes[next];
+    if(_indices)
+    {
+      unindex(lane.events.front());
+    }
+
+    Event e = lane.events.front().event;
+    lane.events.pop_front();
+    --_laneSize;
+
+    return e;
+  }
+
+  if(_indices)
+  {
+    const EventKey key = _backend->peekKey();
+    Event e = _backend->getNext();
+    unindex(KeyedEvent{key, e});
+
+    return e;
+  }
+
+  return _backend->getNext();
+}
+
+EventHandle EventQueue::insertWithHandle(const Event& e)
+{
+  const EventKey key = EventKey::Make(e, EventKey::Next(_sequence));
+  EventHandle handle{this, _backend->insertTracked(e, key)};
+
+  if(_indices)
+  {
+    index(KeyedEvent{key, e});
+  }
+
+  return handle;
+}
+
+void EventQueue::enableIndices()
+{
+  if(!empty())
+  {
+    throw std::runtime_error("Queue is not empty");
+  }
+
+  if(!_indices)
+  {
+    _indices.reset(new Indices{});
+  }
+}
+
+size_t EventQueue::count(const EventType type) const
+{
+  if(!_indices)
+  {
+    throw std::logic_error("Indices are not enabled");
+  }
+
+  auto it = _indices->typeCounts.find(type);
+  return (it != _indices->typeCounts.cend()) ? it->second : 0;
+}
+
+const Event* EventQueue::findNext(const EventTag tag) const
+{
+  if(!_indices)
+  {
+    throw std::logic_error("Indices are not enabled");
+  }
+
+  auto it = _indices->tagEvents.find(tag);
+  return (it != _indices->tagEvents.cend()) ? &it->second.begin()->event : nullptr;
+}
+
+void EventQueue::index(const KeyedEvent& e)
+{
+  ++_indices->typeCounts[e.event.type()];
+  _indices->tagEvents[e.event.tag()].insert(e);
+}
+
+void EventQueue::unindex(const KeyedEvent& e)
+{
+  auto count = _indices->typeCounts.find(e.event.type());
+  if(--count->second == 0)
+  {
+    _indices->typeCounts.erase(count);
+  }
+
+  auto events = _indices->tagEvents.find(e.event.tag());
+  events->second.erase(e);
+  if(events->second.empty())
+  {
+    _indices->tagEvents.erase(events);
+  }
 }
 
 const Event& EventQueue::peekNext() const
 {
-  if(_queue.empty())
+  if(empty())
   {
     throw std::runtime_error("Queue is empty");
   }
 
-  return _queue.top();
+  const size_t next = nextLane();
+  if(next != _lanes.size())
+  {
+    return _lanes[next].events.front().event;
+  }
+
+  return _backend->peekNext();
+}
+
+void EventQueue::addLane(const EventType type, const SimTime delay)
+{
+  if(hasLane(type))
+  {
+    throw std::invalid_argument("Event type already has a lane");
+  }
+
+  _lanes.push_back(Lane{type, delay, RingBuffer<KeyedEvent>{}});
+}
+
+bool EventQueue::hasLane(const EventType type) const noexcept
+{
+  return (findLane(type) != _lanes.size());
+}
+
+SimTime EventQueue::laneDelay(const EventType type) const
+{
+  const size_t lane = findLane(type);
+  if(lane == _lanes.size())
+  {
+    throw std::invalid_argument("Event type has no lane");
+  }
+
+  return _lanes[lane].delay;
+}
+
+void EventQueue::insertKeyed(const Event& e, const EventKey& key)
+{
+  const KeyedEvent keyed{key, e};
+  const size_t laneIndex = findLane(e.type());
+  if((laneIndex != _lanes.size()) &&
+    (_lanes[laneIndex].events.empty() || !(key < _lanes[laneIndex].events.back().key)))
+  {
+    _lanes[laneIndex].events.push_back(keyed);
+    ++_laneSize;
+  }
+  else
+  {
+    _backend->insert(e, key);
+  }
+
+  if(_indices)
+  {
+    index(keyed);
+  }
+}
+
+size_t EventQueue::findLane(const EventType type) const noexcept
+{
+  for(size_t i = 0; i < _lanes.size(); ++i)
+  {
+    if(_lanes[i].type == type)
+    {
+      return i;
+    }
+  }
+
+  return _lanes.size();
+}
+
+size_t EventQueue::nextLane() const
+{
+  if(_laneSize == 0)
+  {
+    return _lanes.size();
+  }
+
+  // Earliest lane head
+  size_t next = _lanes.size();
+  for(size_t i = 0; i < _lanes.size(); ++i)
+  {
+    if(!_lanes[i].events.empty() &&
+      ((next == _lanes.size()) || (_lanes[i].events.front().key < _lanes[next].events.front().key)))
+    {
+      next = i;
+    }
+  }
+
+  if((_backend->size() != 0) && (_backend->peekKey() < _lanes[next].events.front().key))
+  {
+    return _lanes.size();
+  }
+
+  return next;
 }
 
 } // End namespace
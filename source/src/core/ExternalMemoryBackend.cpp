@@ -0,0 +1,393 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/ExternalMemoryBackend.h"
+#include "io/BinaryEventWriter.h"
+#include "io/BinaryEventReader.h"
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+
+namespace des
+{
+
+namespace
+{
+  // Sort events such that events with a smaller key are at the top of the heap
+  inline bool LaterThan(const KeyedEvent& lhs, const KeyedEvent& rhs) noexcept
+  { return (rhs.key < lhs.key); }
+
+  // Sort events in ascending key order
+  inline bool EarlierThan(const KeyedEvent& lhs, const KeyedEvent& rhs) noexcept
+  { return (lhs.key < rhs.key); }
+
+  // Key no event orders after
+  const EventKey MaxKey{std::numeric_limits<SimTime>::max(), std::numeric_limits<uint64_t>::max()};
+}
+
+constexpr size_t ExternalMemoryBackend::DefaultMemoryBudget;
+constexpr size_t ExternalMemoryBackend::MaxRuns;
+
+ExternalMemoryBackend::ExternalMemoryBackend(const std::string& pathPrefix, const size_t memoryBudget) :
+  QueueBackend{},
+  _pathPrefix{pathPrefix},
+  _limit{memoryBudget / sizeof(KeyedEvent)},
+  _runIndex{0},
+  _near{},
+  _far{},
+  _runs{},
+  _horizon(MaxKey),
+  _size{0}
+{
+  if(_limit < 2)
+  {
+    throw std::invalid_argument("Memory budget holds fewer than two events");
+  }
+}
+
+ExternalMemoryBackend::~ExternalMemoryBackend()
+{
+  for(auto& run : _runs)
+  {
+    run.reader.reset();
+    run.file.reset();
+    std::remove(run.path.c_str());
+  }
+}
+
+void ExternalMemoryBackend::insert(const Event& e, const EventKey& key)
+{
+  if(key < _horizon)
+  {
+    _near.push_back(KeyedEvent{key, e});
+    std::push_heap(_near.begin(), _near.end(), LaterThan);
+  }
+  else
+  {
+    _far.push_back(KeyedEvent{key, e});
+  }
+
+  ++_size;
+
+  if(memoryCount() > _limit)
+  {
+    spill();
+  }
+}
+
+Event ExternalMemoryBackend::getNext()
+{
+  refill();
+
+  std::pop_heap(_near.begin(), _near.end(), LaterThan);
+  Event e = _near.back().event;
+  _near.pop_back();
+  --_size;
+
+  return e;
+}
+
+const Event& ExternalMemoryBackend::peekNext() const
+{
+  refill();
+
+  return _near.front().event;
+}
+
+EventKey ExternalMemoryBackend::peekKey() const
+{
+  refill();
+
+  return _near.front().key;
+}
+
+void ExternalMemoryBackend::writeRun(std::vector<KeyedEvent>& events) const
+{
+  assert(!events.empty());
+
+  std::sort(events.begin(), events.end(), EarlierThan);
+
+  const std::string path = nextRunPath();
+  try
+  {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if(!out)
+    {
+      throw std::runtime_error("Failed to create run file");
+    }
+
+    BinaryEventWriter writer{out, BinaryEventFormat::V2};
+    for(const auto& e : events)
+    {
+      WriteRecord(writer, e);
+    }
+
+    writer.stream().flush();
+    if(!writer.stream().good())
+    {
+      throw std::runtime_error("Failed to write run file");
+    }
+
+    out.close();
+    _runs.push_back(OpenRun(path, events.size()));
+  }
+  catch(...)
+  {
+    std::remove(path.c_str());
+    throw;
+  }
+
+  events.clear();
+}
+
+void ExternalMemoryBackend::mergeRuns() const
+{
+  while(_runs.size() > MaxRuns)
+  {
+    // Merging the smaller runs first rewrites each event a logarithmic number of times
+    std::sort(_runs.begin(), _runs.end(), [] (const Run& lhs, const Run& rhs) { return (lhs.remaining < rhs.remaining); });
+    const size_t count = _runs.size() / 2;
+
+    // Read the runs through new handles positioned after their heads
+    std::vector<Run> sources{};
+    size_t total = 0;
+    for(size_t i = 0; i < count; ++i)
+    {
+      const Run& run = _runs[i];
+      Run source{run.path, std::unique_ptr<std::ifstream>{new std::ifstream{run.path, std::ios::binary}}, nullptr,
+        run.remaining, run.head, run.exhausted};
+      source.file->seekg(run.file->tellg());
+      if(!*source.file)
+      {
+        throw std::runtime_error("Failed to open run file");
+      }
+
+      source.reader.reset(new BinaryEventReader{*source.file, BinaryEventFormat::V2});
+      total += run.remaining + (run.exhausted ? 0 : 1);
+      sources.push_back(std::move(source));
+    }
+
+    std::vector<size_t> heads{};
+    for(size_t i = 0; i < sources.size(); ++i)
+    {
+      if(!sources[i].exhausted)
+      {
+        heads.push_back(i);
+      }
+    }
+
+    auto laterHead = [&sources] (const size_t lhs, const size_t rhs) { return (sources[rhs].head.key < sources[lhs].head.key); };
+    std::make_heap(heads.begin(), heads.end(), laterHead);
+
+    const std::string path = nextRunPath();
+    try
+    {
+      std::ofstream out{path, std::ios::binary | std::ios::trunc};
+      if(!out)
+      {
+        throw std::runtime_error("Failed to create run file");
+      }
+
+      BinaryEventWriter writer{out, BinaryEventFormat::V2};
+      while(!heads.empty())
+      {
+        std::pop_heap(heads.begin(), heads.end(), laterHead);
+        Run& source = sources[heads.back()];
+        WriteRecord(writer, source.head);
+
+        ReadHead(source);
+        if(source.exhausted)
+        {
+          heads.pop_back();
+        }
+        else
+        {
+          std::push_heap(heads.begin(), heads.end(), laterHead);
+        }
+      }
+
+      writer.stream().flush();
+      if(!writer.stream().good())
+      {
+        throw std::runtime_error("Failed to write run file");
+      }
+
+      out.close();
+      sources.clear();
+
+      // Replace the merged runs
+      Run merged = OpenRun(path, total);
+      for(size_t i = 0; i < count; ++i)
+      {
+        _runs[i].reader.reset();
+        _runs[i].file.reset();
+        std::remove(_runs[i].path.c_str());
+      }
+
+      _runs.erase(_runs.begin(), _runs.begin() + count);
+      _runs.push_back(std::move(merged));
+    }
+    catch(...)
+    {
+      std::remove(path.c_str());
+      throw;
+    }
+  }
+}
+
+ExternalMemoryBackend::Run ExternalMemoryBackend::OpenRun(const std::string& path, const size_t count)
+{
+  Run run{path, std::unique_ptr<std::ifstream>{new std::ifstream{path, std::ios::binary}}, nullptr,
+    count, KeyedEvent{EventKey{0, 0}, Event{0, 0}}, false};
+  if(!*run.file)
+  {
+    throw std::runtime_error("Failed to open run file");
+  }
+
+  run.reader.reset(new BinaryEventReader{*run.file, BinaryEventFormat::V2});
+  ReadHead(run);
+
+  return run;
+}
+
+void ExternalMemoryBackend::WriteRecord(BinaryEventWriter& writer, const KeyedEvent& e)
+{
+  // Each record is the V2 binary event layout followed by the order word
+  writer.write(e.event);
+  writer.stream().write((const char*)&e.key.order, sizeof(e.key.order));
+}
+
+void ExternalMemoryBackend::ReadHead(Run& run)
+{
+  if(run.remaining == 0)
+  {
+    run.exhausted = true;
+    return;
+  }
+
+  const Event e = run.reader->read();
+
+  uint64_t order = 0;
+  run.reader->stream().read((char*)&order, sizeof(order));
+  if(!run.reader->stream().good())
+  {
+    throw EventReadException{"Stream not good after read"};
+  }
+
+  run.head = KeyedEvent{EventKey{e.time(), order}, e};
+  --run.remaining;
+}
+
+void ExternalMemoryBackend::spill()
+{
+  while(memoryCount() > _limit)
+  {
+    if(_far.size() >= _near.size())
+    {
+      writeRun(_far);
+      continue;
+    }
+
+    // Spill the later half of the heap, moving the horizon down to the earliest spilled event
+    const auto middle = _near.begin() + (_near.size() / 2);
+    std::nth_element(_near.begin(), middle, _near.end(), EarlierThan);
+
+    // Events leave the heap only once written, so a failed write loses nothing
+    std::vector<KeyedEvent> later(middle, _near.end());
+    const EventKey horizon = later.front().key;
+    try
+    {
+      writeRun(later);
+    }
+    catch(...)
+    {
+      std::make_heap(_near.begin(), _near.end(), LaterThan);
+      throw;
+    }
+
+    _near.erase(middle, _near.end());
+    std::make_heap(_near.begin(), _near.end(), LaterThan);
+    _horizon = horizon;
+  }
+
+  mergeRuns();
+}
+
+void ExternalMemoryBackend::refill() const
+{
+  assert(_size > 0);
+
+  if(!_near.empty())
+  {
+    return;
+  }
+
+  // Leave room in memory for at least half a window of events from the runs
+  if(!_runs.empty() && (_far.size() > (_limit / 2)))
+  {
+    writeRun(_far);
+    mergeRuns();
+  }
+
+  // Merge the next window of events from the runs in key order
+  std::vector<size_t> heads{};
+  for(size_t i = 0; i < _runs.size(); ++i)
+  {
+    heads.push_back(i);
+  }
+
+  auto laterHead = [this] (const size_t lhs, const size_t rhs) { return (_runs[rhs].head.key < _runs[lhs].head.key); };
+  std::make_heap(heads.begin(), heads.end(), laterHead);
+
+  const size_t window = _limit - _far.size();
+  while(!heads.empty() && (_near.size() < window))
+  {
+    std::pop_heap(heads.begin(), heads.end(), laterHead);
+    Run& run = _runs[heads.back()];
+    _near.push_back(run.head);
+
+    ReadHead(run);
+    if(run.exhausted)
+    {
+      heads.pop_back();
+    }
+    else
+    {
+      std::push_heap(heads.begin(), heads.end(), laterHead);
+    }
+  }
+
+  // Move buffered events earlier than the new horizon into the heap
+  if(heads.empty())
+  {
+    _horizon = MaxKey;
+    _near.insert(_near.end(), _far.begin(), _far.end());
+    _far.clear();
+  }
+  else
+  {
+    _horizon = _runs[heads.front()].head.key;
+    const auto middle = std::partition(_far.begin(), _far.end(),
+      [this] (const KeyedEvent& e) { return !(e.key < _horizon); });
+    _near.insert(_near.end(), middle, _far.end());
+    _far.erase(middle, _far.end());
+  }
+
+  std::make_heap(_near.begin(), _near.end(), LaterThan);
+
+  // Remove runs that are fully merged
+  for(auto& run : _runs)
+  {
+    if(run.exhausted)
+    {
+      run.reader.reset();
+      run.file.reset();
+      std::remove(run.path.c_str());
+    }
+  }
+
+  _runs.erase(std::remove_if(_runs.begin(), _runs.end(), [] (const Run& run) { return run.exhausted; }), _runs.end());
+}
+
+} // End namespace
@@ -0,0 +1,230 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/LadderQueueBackend.h"
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+namespace des
+{
+
+namespace
+{
+  // Order heaps such that the event with the smallest key is at the front
+  inline bool LaterThan(const KeyedEvent& lhs, const KeyedEvent& rhs) noexcept
+  { return (rhs.key < lhs.key); }
+}
+
+constexpr size_t LadderQueueBackend::Threshold;
+constexpr size_t LadderQueueBackend::MaxRungs;
+
+LadderQueueBackend::LadderQueueBackend() :
+  QueueBackend{},
+  _top{},
+  _topStart{0},
+  _topMin{std::numeric_limits<SimTime>::max()},
+  _topMax{0},
+  _rungs{},
+  _bottom{},
+  _spillSize{Threshold},
+  _size{0}
+{
+}
+
+LadderQueueBackend::~LadderQueueBackend()
+{
+}
+
+void LadderQueueBackend::insert(const Event& e, const EventKey& key)
+{
+  ++_size;
+
+  // Far-future events go to Top
+  const KeyedEvent keyed{key, e};
+  const SimTime t = e.time();
+  if(t >= _topStart)
+  {
+    _top.push_back(keyed);
+    _topMin = std::min(_topMin, t);
+    _topMax = std::max(_topMax, t);
+    return;
+  }
+
+  // Find the first rung whose unconsumed buckets cover the event
+  for(auto& rung : _rungs)
+  {
+    if(t >= rung.start)
+    {
+      assert(t <= rung.last);
+      const size_t index = std::min<SimTime>((t - rung.start) / rung.width, rung.buckets.size() - 1);
+      if(index >= rung.current)
+      {
+        rung.buckets[index].push_back(keyed);
+        ++rung.count;
+        return;
+      }
+    }
+  }
+
+  // Event precedes all buckets
+  insertBottom(keyed);
+}
+
+Event LadderQueueBackend::getNext()
+{
+  refill();
+
+  std::pop_heap(_bottom.begin(), _bottom.end(), LaterThan);
+  Event e = _bottom.back().event;
+  _bottom.pop_back();
+  --_size;
+
+  return e;
+}
+
+const Event& LadderQueueBackend::peekNext() const
+{
+  refill();
+
+  return _bottom.front().event;
+}
+
+EventKey LadderQueueBackend::peekKey() const
+{
+  refill();
+
+  return _bottom.front().key;
+}
+
+SimTime LadderQueueBackend::spawnRung(const std::vector<KeyedEvent>& events, const SimTime start, const SimTime last) const
+{
+  assert(!events.empty());
+
+  // Size buckets to hold one event each on average over the span of the events,
+  // with one more bucket for the rest of the rung if the events end before it
+  const SimTime latest = std::max_element(events.cbegin(), events.cend(),
+    [] (const KeyedEvent& lhs, const KeyedEvent& rhs) { return (lhs.key.time < rhs.key.time); })->key.time;
+  const SimTime width = ((latest - start) / events.size()) + 1;
+  const size_t bucketCount = std::min<SimTime>((last - start) / width, ((latest - start) / width) + 1) + 1;
+
+  Rung rung{start, width, last, 0, events.size(), std::vector<std::vector<KeyedEvent>>(bucketCount)};
+  for(const auto& e : events)
+  {
+    rung.buckets[std::min<SimTime>((e.key.time - start) / width, bucketCount - 1)].push_back(e);
+  }
+
+  _rungs.push_back(std::move(rung));
+
+  // Time following the last bucket
+  if(last == std::numeric_limits<SimTime>::max())
+  {
+    return last;
+  }
+
+  return last + 1;
+}
+
+void LadderQueueBackend::insertBottom(const KeyedEvent& e)
+{
+  _bottom.push_back(e);
+  std::push_heap(_bottom.begin(), _bottom.end(), LaterThan);
+
+  // Spread a large Bottom over a new rung
+  if((_bottom.size() <= _spillSize) || (_rungs.size() >= MaxRungs))
+  {
+    return;
+  }
+
+  // Events all at one time can't be split up, so wait for Bottom to double before trying again
+  const SimTime earliest = _bottom.front().key.time;
+  if(std::all_of(_bottom.cbegin(), _bottom.cend(), [earliest] (const KeyedEvent& b) { return (b.key.time == earliest); }))
+  {
+    _spillSize = 2 * _bottom.size();
+    return;
+  }
+
+  while(!_rungs.empty() && (_rungs.back().count == 0))
+  {
+    _rungs.pop_back();
+  }
+
+  // Bottom precedes the next bucket of the lowest rung, or Top if the ladder is empty
+  SimTime last = _topStart - 1;
+  if(!_rungs.empty())
+  {
+    const Rung& rung = _rungs.back();
+    last = rung.start + (rung.current * rung.width) - 1;
+  }
+
+  spawnRung(_bottom, earliest, last);
+  _bottom.clear();
+  _spillSize = Threshold;
+}
+
+void LadderQueueBackend::refill() const
+{
+  assert(_size > 0);
+
+  while(_bottom.empty())
+  {
+    // Ladder is empty, move Top into a new rung
+    if(_rungs.empty())
+    {
+      assert(!_top.empty());
+
+      _topStart = spawnRung(_top, _topMin, _topMax);
+      _top.clear();
+      _topMin = std::numeric_limits<SimTime>::max();
+      _topMax = 0;
+      continue;
+    }
+
+    // Remove the lowest rung once all of its buckets are consumed
+    Rung& rung = _rungs.back();
+    if(rung.count == 0)
+    {
+      _rungs.pop_back();
+      continue;
+    }
+
+    // Take the next non-empty bucket
+    while(rung.buckets[rung.current].empty())
+    {
+      ++rung.current;
+    }
+
+    const SimTime bucketStart = rung.start + (rung.current * rung.width);
+    const SimTime bucketLast = (rung.current + 1 == rung.buckets.size()) ?
+      rung.last : (bucketStart + rung.width - 1);
+
+    std::vector<KeyedEvent> events{};
+    events.swap(rung.buckets[rung.current]);
+    ++rung.current;
+    rung.count -= events.size();
+
+    // A rung with all of its buckets consumed covers nothing more, so the finer
+    // rung replaces it rather than nesting ever deeper
+    if(rung.current == rung.buckets.size())
+    {
+      assert(rung.count == 0);
+      _rungs.pop_back();
+    }
+
+    // Split large buckets into a finer rung, otherwise order the bucket in Bottom
+    if((events.size() > Threshold) && (_rungs.size() < MaxRungs) && (bucketLast > bucketStart))
+    {
+      const SimTime earliest = std::min_element(events.cbegin(), events.cend(),
+        [] (const KeyedEvent& lhs, const KeyedEvent& rhs) { return (lhs.key.time < rhs.key.time); })->key.time;
+
+      spawnRung(events, earliest, bucketLast);
+    }
+    else
+    {
+      _bottom.swap(events);
+      std::make_heap(_bottom.begin(), _bottom.end(), LaterThan);
+      _spillSize = Threshold;
+    }
+  }
+}
+
+} // End namespace
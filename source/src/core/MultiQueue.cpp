@@ -0,0 +1,143 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/MultiQueue.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace des
+{
+
+namespace
+{
+  // Sort events such that events with a smaller key are at the top of the heap
+  inline bool LaterThan(const KeyedEvent& lhs, const KeyedEvent& rhs) noexcept
+  { return (rhs.key < lhs.key); }
+
+  // Cached top time of an empty heap
+  constexpr SimTime EmptyTime = std::numeric_limits<SimTime>::max();
+}
+
+MultiQueue::Heap::Heap() :
+  lock{},
+  events{},
+  top{EmptyTime}
+{
+}
+
+MultiQueue::MultiQueue(const size_t queueCount) :
+  _heaps{},
+  _size{0},
+  _sequence{0}
+{
+  if(queueCount == 0)
+  {
+    throw std::invalid_argument("Queue count is zero");
+  }
+
+  for(size_t i = 0; i < queueCount; ++i)
+  {
+    _heaps.emplace_back(new Heap{});
+  }
+}
+
+MultiQueue::MultiQueue() :
+  MultiQueue{2 * std::max(1u, std::thread::hardware_concurrency())}
+{
+}
+
+MultiQueue::~MultiQueue()
+{
+}
+
+void MultiQueue::insert(const Event& e)
+{
+  const KeyedEvent keyed{EventKey::Make(e, EventKey::Checked(_sequence.fetch_add(1, std::memory_order_relaxed))), e};
+
+  while(true)
+  {
+    // Skip heaps locked by other threads rather than waiting for them
+    Heap& heap = *_heaps[randomHeap()];
+    std::unique_lock<std::mutex> guard{heap.lock, std::defer_lock};
+    if(_heaps.size() == 1)
+    {
+      guard.lock();
+    }
+    else if(!guard.try_lock())
+    {
+      continue;
+    }
+
+    heap.events.push_back(keyed);
+    std::push_heap(heap.events.begin(), heap.events.end(), LaterThan);
+    heap.top.store(heap.events.front().key.time, std::memory_order_relaxed);
+    _size.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+}
+
+bool MultiQueue::tryGetNext(Event& e)
+{
+  // Pop from the better of two random heaps
+  for(size_t attempt = 0; (attempt < 2 * _heaps.size()) && (size() > 0); ++attempt)
+  {
+    size_t index = randomHeap();
+    const size_t other = randomHeap();
+    if(_heaps[other]->top.load(std::memory_order_relaxed) < _heaps[index]->top.load(std::memory_order_relaxed))
+    {
+      index = other;
+    }
+
+    Heap& heap = *_heaps[index];
+    if(heap.top.load(std::memory_order_relaxed) == EmptyTime)
+    {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> guard{heap.lock, std::try_to_lock};
+    if(guard.owns_lock() && pop(heap, e))
+    {
+      return true;
+    }
+  }
+
+  // Few events left or heavy contention, visit every heap in turn
+  for(auto& heap : _heaps)
+  {
+    std::lock_guard<std::mutex> guard{heap->lock};
+    if(pop(*heap, e))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+size_t MultiQueue::randomHeap() const
+{
+  static thread_local std::minstd_rand rng{(std::minstd_rand::result_type)std::hash<std::thread::id>{}(std::this_thread::get_id())};
+
+  return (rng() % _heaps.size());
+}
+
+bool MultiQueue::pop(Heap& heap, Event& e)
+{
+  if(heap.events.empty())
+  {
+    return false;
+  }
+
+  std::pop_heap(heap.events.begin(), heap.events.end(), LaterThan);
+  e = heap.events.back().event;
+  heap.events.pop_back();
+  heap.top.store(heap.events.empty() ? EmptyTime : heap.events.front().key.time, std::memory_order_relaxed);
+  _size.fetch_sub(1, std::memory_order_relaxed);
+
+  return true;
+}
+
+} // End namespace
@@ -0,0 +1,123 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/PartitionedBackend.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+
+namespace des
+{
+
+namespace
+{
+  // Sort events such that events with a smaller key are at the top of the heap
+  inline bool LaterThan(const KeyedEvent& lhs, const KeyedEvent& rhs) noexcept
+  { return (rhs.key < lhs.key); }
+
+  // Key of an empty partition, losing to every event
+  const EventKey EmptyKey{std::numeric_limits<SimTime>::max(), std::numeric_limits<uint64_t>::max()};
+}
+
+constexpr size_t PartitionedBackend::DefaultPartitions;
+
+PartitionedBackend::PartitionedBackend(const size_t partitionCount) :
+  QueueBackend{},
+  _partitions{},
+  _tree{},
+  _leaves{1},
+  _size{0}
+{
+  if(partitionCount == 0)
+  {
+    throw std::invalid_argument("Partition count is zero");
+  }
+
+  if(partitionCount > std::numeric_limits<uint32_t>::max())
+  {
+    throw std::invalid_argument("Partition count is too large");
+  }
+
+  _partitions.resize(partitionCount);
+  while(_leaves < partitionCount)
+  {
+    _leaves *= 2;
+  }
+
+  // Leaves without a partition are never replayed, so they always lose
+  _tree.resize(2 * _leaves, Node{EmptyKey, 0});
+  for(size_t i = 0; i < _leaves; ++i)
+  {
+    _tree[_leaves + i].partition = (uint32_t)std::min(i, partitionCount - 1);
+  }
+
+  for(size_t node = _leaves - 1; node > 0; --node)
+  {
+    _tree[node] = _tree[2 * node];
+  }
+}
+
+PartitionedBackend::~PartitionedBackend()
+{
+}
+
+void PartitionedBackend::insert(const Event& e, const EventKey& key)
+{
+  const size_t index = partition(e.type());
+  auto& events = _partitions[index];
+
+  events.push_back(KeyedEvent{key, e});
+  std::push_heap(events.begin(), events.end(), LaterThan);
+  ++_size;
+
+  // Tree only changes if the event is the new head of its partition
+  if((events.size() == 1) || (key < _tree[_leaves + index].key))
+  {
+    replay(index);
+  }
+}
+
+Event PartitionedBackend::getNext()
+{
+  const size_t index = _tree[1].partition;
+  auto& events = _partitions[index];
+  assert(!events.empty());
+
+  std::pop_heap(events.begin(), events.end(), LaterThan);
+  Event e = events.back().event;
+  events.pop_back();
+  --_size;
+
+  replay(index);
+
+  return e;
+}
+
+const Event& PartitionedBackend::peekNext() const
+{
+  return _partitions[_tree[1].partition].front().event;
+}
+
+EventKey PartitionedBackend::peekKey() const
+{
+  return _tree[1].key;
+}
+
+void PartitionedBackend::replay(const size_t index) noexcept
+{
+  const auto& events = _partitions[index];
+
+  size_t node = _leaves + index;
+  _tree[node].key = events.empty() ? EmptyKey : events.front().key;
+
+  // Replay the matches on the path to the root
+  while(node > 1)
+  {
+    node /= 2;
+    const Node& left = _tree[2 * node];
+    const Node& right = _tree[(2 * node) + 1];
+    _tree[node] = (right.key < left.key) ? right : left;
+  }
+}
+
+} // End namespace
@@ -0,0 +1,157 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/RadixHeapBackend.h"
+#include <algorithm>
+#include <cassert>
+
+namespace des
+{
+
+namespace
+{
+  // Sort events such that events with a smaller key are at the top of the heap
+  inline bool LaterThan(const KeyedEvent& lhs, const KeyedEvent& rhs) noexcept
+  { return (rhs.key < lhs.key); }
+}
+
+constexpr size_t RadixHeapBackend::NumBuckets;
+
+RadixHeapBackend::RadixHeapBackend() :
+  QueueBackend{},
+  _last{0},
+  _early{},
+  _size{0}
+{
+}
+
+RadixHeapBackend::~RadixHeapBackend()
+{
+}
+
+size_t RadixHeapBackend::BucketIndex(const SimTime t, const SimTime last) noexcept
+{
+  SimTime diff = t ^ last;
+  if(diff == 0)
+  {
+    return 0;
+  }
+
+#if defined(__GNUC__) || defined(__clang__)
+  return std::numeric_limits<SimTime>::digits - __builtin_clzll(diff);
+#else
+  size_t index = 0;
+  while(diff != 0)
+  {
+    diff >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+void RadixHeapBackend::insert(const Event& e, const EventKey& key)
+{
+  const KeyedEvent keyed{key, e};
+  if(e.time() < _last)
+  {
+    _early.push_back(keyed);
+    std::push_heap(_early.begin(), _early.end(), LaterThan);
+  }
+  else
+  {
+    place(keyed);
+  }
+
+  ++_size;
+}
+
+Event RadixHeapBackend::getNext()
+{
+  refill();
+
+  if(!_early.empty())
+  {
+    std::pop_heap(_early.begin(), _early.end(), LaterThan);
+    Event e = _early.back().event;
+    _early.pop_back();
+    --_size;
+
+    return e;
+  }
+
+  auto& current = _buckets[0];
+  std::pop_heap(current.begin(), current.end(), LaterThan);
+  Event e = current.back().event;
+  current.pop_back();
+  --_size;
+
+  return e;
+}
+
+const Event& RadixHeapBackend::peekNext() const
+{
+  refill();
+
+  if(!_early.empty())
+  {
+    return _early.front().event;
+  }
+
+  return _buckets[0].front().event;
+}
+
+EventKey RadixHeapBackend::peekKey() const
+{
+  refill();
+
+  if(!_early.empty())
+  {
+    return _early.front().key;
+  }
+
+  return _buckets[0].front().key;
+}
+
+void RadixHeapBackend::refill() const
+{
+  assert(_size > 0);
+
+  if(!_early.empty() || !_buckets[0].empty())
+  {
+    return;
+  }
+
+  // Find the first non-empty bucket
+  size_t index = 1;
+  while(_buckets[index].empty())
+  {
+    ++index;
+    assert(index < NumBuckets);
+  }
+
+  // Re-key from the earliest event in the bucket, all of its events move to lower buckets
+  auto& bucket = _buckets[index];
+  _last = std::min_element(bucket.cbegin(), bucket.cend(),
+    [] (const KeyedEvent& lhs, const KeyedEvent& rhs) { return (lhs.key.time < rhs.key.time); })->key.time;
+
+  for(const auto& e : bucket)
+  {
+    place(e);
+  }
+
+  bucket.clear();
+}
+
+void RadixHeapBackend::place(const KeyedEvent& e) const
+{
+  const size_t index = BucketIndex(e.key.time, _last);
+  _buckets[index].push_back(e);
+
+  // Events in bucket 0 share the same time, and are kept as a heap ordered by key
+  if(index == 0)
+  {
+    std::push_heap(_buckets[0].begin(), _buckets[0].end(), LaterThan);
+  }
+}
+
+} // End namespace
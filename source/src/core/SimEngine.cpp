@@ -4,8 +4,12 @@
 #include "core/SimEngine.h"
 #include <stdexcept>
 #include <cassert>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <set>
 #include <map>
+#include <unordered_set>
 
 namespace des
 {
@@ -14,8 +18,59 @@ SimEngine::SimEngine() :
   _time{0},
   _state{SimEngineState::Uninitialized},
   _schedule{EventQueue{}},
-  _globalHandlers{std::set<EventHandler*>{}},
-  _typeHandlers{std::map<EventType, std::set<EventHandler*>>{}}
+  _globalHandlers{std::vector<EventHandler*>{}},
+  _typeHandlers{std::map<EventType, std::vector<EventHandler*>>{}},
+  _priorities{std::unordered_map<EventHandler*, HandlerPriority>{}},
+  _filters{std::vector<TypeFilter>{}},
+  _targets{std::vector<EventHandler*>{}},
+  _keyedHandlers{std::unordered_map<uint64_t, KeyedHandler>{}},
+  _subscriptions{std::unordered_map<EventHandler*, Subscriptions>{}},
+  _dispatch{},
+  _dispatchStale{true},
+  _dispatching{false},
+  _pendingChanges{},
+  _pendingKeys{},
+  _batch{}
+{
+}
+
+SimEngine::SimEngine(const QueueBackendType backendType) :
+  _time{0},
+  _state{SimEngineState::Uninitialized},
+  _schedule{backendType},
+  _globalHandlers{std::vector<EventHandler*>{}},
+  _typeHandlers{std::map<EventType, std::vector<EventHandler*>>{}},
+  _priorities{std::unordered_map<EventHandler*, HandlerPriority>{}},
+  _filters{std::vector<TypeFilter>{}},
+  _targets{std::vector<EventHandler*>{}},
+  _keyedHandlers{std::unordered_map<uint64_t, KeyedHandler>{}},
+  _subscriptions{std::unordered_map<EventHandler*, Subscriptions>{}},
+  _dispatch{},
+  _dispatchStale{true},
+  _dispatching{false},
+  _pendingChanges{},
+  _pendingKeys{},
+  _batch{}
+{
+}
+
+SimEngine::SimEngine(std::unique_ptr<QueueBackend> backend) :
+  _time{0},
+  _state{SimEngineState::Uninitialized},
+  _schedule{std::move(backend)},
+  _globalHandlers{std::vector<EventHandler*>{}},
+  _typeHandlers{std::map<EventType, std::vector<EventHandler*>>{}},
+  _priorities{std::unordered_map<EventHandler*, HandlerPriority>{}},
+  _filters{std::vector<TypeFilter>{}},
+  _targets{std::vector<EventHandler*>{}},
+  _keyedHandlers{std::unordered_map<uint64_t, KeyedHandler>{}},
+  _subscriptions{std::unordered_map<EventHandler*, Subscriptions>{}},
+  _dispatch{},
+  _dispatchStale{true},
+  _dispatching{false},
+  _pendingChanges{},
+  _pendingKeys{},
+  _batch{}
 {
 }
 
@@ -23,6 +78,22 @@ SimEngine::~SimEngine()
 {
 }
 
+namespace
+{
+  // Remove a handler from a list of handlers, returning true if it was listed
+  inline bool EraseHandler(std::vector<EventHandler*>& handlers, EventHandler* handler)
+  {
+    auto it = std::find(handlers.begin(), handlers.end(), handler);
+    if(it == handlers.end())
+    {
+      return false;
+    }
+
+    handlers.erase(it);
+    return true;
+  }
+}
+
 void SimEngine::subscribe(EventHandler* handler)
 {
   if(!handler)
@@ -30,13 +101,53 @@ void SimEngine::subscribe(EventHandler* handler)
     throw std::invalid_argument("Handler is null");
   }
 
+  if(_dispatching)
+  {
+    queueChange(ChangeOp::Subscribe, handler);
+    return;
+  }
+
+  bool joined = false;
+  Subscriptions& subscriptions = subscriptionsOf(handler, joined);
+
   // Don't double-subscribe handler
-  for(auto& it : _typeHandlers)
+  for(auto evtType : subscriptions.types)
+  {
+    eraseTypeHandler(handler, evtType);
+  }
+
+  const std::vector<TypeFilter> filters{(subscriptions.filters > 0) ? eraseFilters(handler) : std::vector<TypeFilter>{}};
+  subscriptions.filters = 0;
+
+  for(auto key : subscriptions.keys)
+  {
+    _keyedHandlers.erase(key);
+  }
+  subscriptions.keys.clear();
+
+  // Keep the original position of a handler that is already subscribed
+  if(!subscriptions.global)
   {
-    it.second.erase(handler);
+    subscriptions.global = true;
+    _globalHandlers.push_back(handler);
+    globalChanged();
   }
 
-  _globalHandlers.insert(handler);
+  for(auto evtType : subscriptions.types)
+  {
+    typeChanged(evtType);
+  }
+  subscriptions.types.clear();
+
+  for(const auto& filter : filters)
+  {
+    filterChanged(filter);
+  }
+
+  if(joined)
+  {
+    join(handler);
+  }
 }
 
 void SimEngine::subscribe(EventHandler* handler, EventType evtType)
@@ -46,11 +157,346 @@ void SimEngine::subscribe(EventHandler* handler, EventType evtType)
     throw std::invalid_argument("Handler is null");
   }
 
+  if(_dispatching)
+  {
+    queueChange(ChangeOp::SubscribeType, handler, evtType);
+    return;
+  }
+
+  bool joined = false;
+  Subscriptions& subscriptions = subscriptionsOf(handler, joined);
+
   // Don't double-subscribe handler
-  _globalHandlers.erase(handler);
+  if(subscriptions.global)
+  {
+    subscriptions.global = false;
+    EraseHandler(_globalHandlers, handler);
+    globalChanged();
+  }
+
+  // Keep the original position of a handler that is already subscribed
+  if(std::find(subscriptions.types.cbegin(), subscriptions.types.cend(), evtType) == subscriptions.types.cend())
+  {
+    subscriptions.types.push_back(evtType);
+    _typeHandlers[evtType].push_back(handler);
+    typeChanged(evtType);
+    keyedChanged(handler, subscriptions);
+  }
+
+  if(joined)
+  {
+    join(handler);
+  }
+}
+
+void SimEngine::subscribe(EventHandler* handler, EventType evtType, EventTag evtTag)
+{
+  if(!handler)
+  {
+    throw std::invalid_argument("Handler is null");
+  }
+
+  const uint64_t key = SubscriptionKey(evtType, evtTag);
+  auto it = _keyedHandlers.find(key);
+  if(_dispatching)
+  {
+    // Check against the keys queued earlier in the dispatch as well, so a conflict is reported to the
+    // caller rather than thrown when the queued changes are applied
+    auto pending = _pendingKeys.find(key);
+    EventHandler* owner = (pending != _pendingKeys.cend()) ? pending->second :
+      ((it != _keyedHandlers.cend()) ? it->second.handler : nullptr);
+    if(owner && (owner != handler))
+    {
+      throw std::invalid_argument("Event type and tag already have a handler");
+    }
+
+    _pendingKeys[key] = handler;
+    queueChange(ChangeOp::SubscribeKey, handler, evtType, evtTag);
+    return;
+  }
+
+  if((it != _keyedHandlers.cend()) && (it->second.handler != handler))
+  {
+    throw std::invalid_argument("Event type and tag already have a handler");
+  }
+
+  bool joined = false;
+  Subscriptions& subscriptions = subscriptionsOf(handler, joined);
+
+  if(it == _keyedHandlers.cend())
+  {
+    _keyedHandlers[key] = KeyedHandler{handler, subscribedTo(handler, subscriptions, evtType)};
+    subscriptions.keys.push_back(key);
+  }
+
+  // Don't double-subscribe handler
+  if(subscriptions.global)
+  {
+    subscriptions.global = false;
+    EraseHandler(_globalHandlers, handler);
+    globalChanged();
+  }
+
+  if(joined)
+  {
+    join(handler);
+  }
+}
+
+void SimEngine::subscribeRange(EventHandler* handler, const EventType firstType, const EventType lastType)
+{
+  if(firstType > lastType)
+  {
+    throw std::invalid_argument("First type is greater than last type");
+  }
+
+  addFilter(TypeFilter{handler, firstType, lastType, 0, 0});
+}
+
+void SimEngine::subscribeMask(EventHandler* handler, const EventType mask, const EventType value)
+{
+  if((value & ~mask) != 0)
+  {
+    throw std::invalid_argument("Value has bits set outside the mask");
+  }
+
+  addFilter(TypeFilter{handler, 0, std::numeric_limits<EventType>::max(), mask, value});
+}
+
+void SimEngine::addFilter(const TypeFilter& filter)
+{
+  if(!filter.handler)
+  {
+    throw std::invalid_argument("Handler is null");
+  }
+
+  if(_dispatching)
+  {
+    _pendingChanges.push_back(PendingChange{ChangeOp::AddFilter, filter.handler, 0, 0, 0, filter});
+    return;
+  }
+
+  bool joined = false;
+  Subscriptions& subscriptions = subscriptionsOf(filter.handler, joined);
+
+  // Don't double-subscribe handler
+  if(subscriptions.global)
+  {
+    subscriptions.global = false;
+    EraseHandler(_globalHandlers, filter.handler);
+    globalChanged();
+  }
+
+  if(std::find(_filters.cbegin(), _filters.cend(), filter) == _filters.cend())
+  {
+    _filters.push_back(filter);
+    ++subscriptions.filters;
+    filterChanged(filter);
+    keyedChanged(filter.handler, subscriptions);
+  }
+
+  if(joined)
+  {
+    join(filter.handler);
+  }
+}
+
+void SimEngine::unsubscribe(EventHandler* handler)
+{
+  if(!handler)
+  {
+    throw std::invalid_argument("Handler is null");
+  }
+
+  if(_dispatching)
+  {
+    queueChange(ChangeOp::Unsubscribe, handler);
+    return;
+  }
+
+  _priorities.erase(handler);
+
+  auto it = _subscriptions.find(handler);
+  if(it == _subscriptions.end())
+  {
+    return;
+  }
+
+  // Remove the subscriptions before updating the dispatch table, so each entry is rewritten once
+  Subscriptions& subscriptions = it->second;
+  if(subscriptions.global)
+  {
+    EraseHandler(_globalHandlers, handler);
+  }
+
+  for(auto evtType : subscriptions.types)
+  {
+    eraseTypeHandler(handler, evtType);
+  }
+
+  const std::vector<TypeFilter> filters{(subscriptions.filters > 0) ? eraseFilters(handler) : std::vector<TypeFilter>{}};
+
+  for(auto key : subscriptions.keys)
+  {
+    _keyedHandlers.erase(key);
+  }
+
+  // Keep the id slot so pending events addressed to the handler are recognized and discarded
+  if(subscriptions.target != Event::NoTarget)
+  {
+    _targets[subscriptions.target - 1] = nullptr;
+  }
 
-  auto& handlers = _typeHandlers[evtType];
-  handlers.insert(handler);
+  if(subscriptions.global)
+  {
+    globalChanged();
+  }
+
+  for(auto evtType : subscriptions.types)
+  {
+    typeChanged(evtType);
+  }
+
+  for(const auto& filter : filters)
+  {
+    filterChanged(filter);
+  }
+
+  _subscriptions.erase(it);
+  leave(handler);
+}
+
+void SimEngine::unsubscribe(EventHandler* handler, EventType evtType)
+{
+  if(!handler)
+  {
+    throw std::invalid_argument("Handler is null");
+  }
+
+  if(_dispatching)
+  {
+    queueChange(ChangeOp::UnsubscribeType, handler, evtType);
+    return;
+  }
+
+  auto it = _subscriptions.find(handler);
+  if(it == _subscriptions.end())
+  {
+    return;
+  }
+
+  auto& types = it->second.types;
+  auto typeIt = std::find(types.begin(), types.end(), evtType);
+  if(typeIt == types.end())
+  {
+    return;
+  }
+
+  types.erase(typeIt);
+  eraseTypeHandler(handler, evtType);
+  typeChanged(evtType);
+  keyedChanged(handler, it->second);
+
+  if(it->second.empty())
+  {
+    _priorities.erase(handler);
+    _subscriptions.erase(it);
+    leave(handler);
+  }
+}
+
+HandlerId SimEngine::registerTarget(EventHandler* handler)
+{
+  if(!handler)
+  {
+    throw std::invalid_argument("Handler is null");
+  }
+
+  bool joined = false;
+  Subscriptions& subscriptions = subscriptionsOf(handler, joined);
+  if(subscriptions.target != Event::NoTarget)
+  {
+    return subscriptions.target;
+  }
+
+  _targets.push_back(handler);
+  const HandlerId id = (HandlerId)_targets.size();
+  subscriptions.target = id;
+
+  // The id is needed straight away, but a handler joining while dispatching is initialized with the queued changes
+  if(joined && _dispatching)
+  {
+    queueChange(ChangeOp::Initialize, handler);
+  }
+  else if(joined)
+  {
+    join(handler);
+  }
+
+  return id;
+}
+
+void SimEngine::setHandlerPriority(EventHandler* handler, const HandlerPriority priority)
+{
+  if(!handler)
+  {
+    throw std::invalid_argument("Handler is null");
+  }
+
+  if(_dispatching)
+  {
+    queueChange(ChangeOp::SetPriority, handler, 0, 0, priority);
+    return;
+  }
+
+  if(handlerPriority(handler) == priority)
+  {
+    return;
+  }
+
+  if(priority == 0)
+  {
+    _priorities.erase(handler);
+  }
+  else
+  {
+    _priorities[handler] = priority;
+  }
+
+  // Rewrite the dispatch table entries the handler appears in
+  auto it = _subscriptions.find(handler);
+  if(it == _subscriptions.cend())
+  {
+    return;
+  }
+
+  const Subscriptions& subscriptions = it->second;
+  if(subscriptions.global)
+  {
+    globalChanged();
+  }
+
+  for(auto evtType : subscriptions.types)
+  {
+    typeChanged(evtType);
+  }
+
+  if(subscriptions.filters > 0)
+  {
+    for(const auto& filter : _filters)
+    {
+      if(filter.handler == handler)
+      {
+        filterChanged(filter);
+      }
+    }
+  }
+}
+
+HandlerPriority SimEngine::handlerPriority(EventHandler* handler) const noexcept
+{
+  auto it = _priorities.find(handler);
+  return (it != _priorities.cend()) ? it->second : 0;
 }
 
 void SimEngine::initialize()
@@ -62,13 +508,15 @@ void SimEngine::initialize()
 
   try
   {
-    const auto& handlers = getAllHandlers();
+    const auto& handlers = orderedHandlers();
     for(auto handler : handlers)
     {
       assert(handler);
       handler->initialize(*this);
     }
 
+    compileDispatch();
+
     _state = SimEngineState::Running;
     return;
   }
@@ -103,25 +551,73 @@ Event SimEngine::step()
     // Update simulation time
     _time = evt.time();
 
-    // Pass event to all global handlers
-    for(auto handler : _globalHandlers)
+    dispatch(evt);
+
+    return evt;
+  }
+  catch(const CausalityException&)
+  {
+    throw;
+  }
+  catch(...)
+  {
+    _state = SimEngineState::Error;
+    throw;
+  }
+}
+
+size_t SimEngine::stepBatch(const bool groupByType)
+{
+  if(_state != SimEngineState::Running)
+  {
+    throw std::runtime_error("Simulation is not Running");
+  }
+
+  if(_schedule.empty())
+  {
+    throw std::runtime_error("Schedule is empty");
+  }
+
+  try
+  {
+    const SimTime batchTime = _schedule.peekNext().time();
+    if(batchTime < _time)
+    {
+      throw CausalityException(_schedule.getNext(), "Event violates causality");
+    }
+
+    _batch.clear();
+    while(!_schedule.empty() && (_schedule.peekNext().time() == batchTime))
     {
-      assert(handler);
-      handler->handleEvent(*this, evt);
+      _batch.push_back(_schedule.getNext());
+    }
+
+    // Update simulation time
+    _time = batchTime;
+
+    // Stable sort keeps the schedule order of events of the same type and target
+    if(groupByType)
+    {
+      std::stable_sort(_batch.begin(), _batch.end(), [] (const Event& lhs, const Event& rhs)
+        { return ((lhs.type() < rhs.type()) || ((lhs.type() == rhs.type()) && (lhs.target() < rhs.target()))); });
     }
 
-    // Pass event to all handlers subscribed to the event type
-    auto it = _typeHandlers.find(evt.type());
-    if(it != _typeHandlers.cend())
+    // Pass each run of events of the same type and target to the handlers as one span
+    const Event* first = _batch.data();
+    const Event* const last = first + _batch.size();
+    while(first != last)
     {
-      for(auto handler : it->second)
+      const Event* runLast = first + 1;
+      while((runLast != last) && (runLast->type() == first->type()) && (runLast->target() == first->target()))
       {
-        assert(handler);
-        handler->handleEvent(*this, evt);
+        ++runLast;
       }
+
+      dispatchBatch(EventSpan{first, runLast});
+      first = runLast;
     }
 
-    return evt;
+    return _batch.size();
   }
   catch(const CausalityException&)
   {
@@ -134,6 +630,120 @@ Event SimEngine::step()
   }
 }
 
+void SimEngine::dispatchKeyedBatch(const EventSpan& events)
+{
+  const EventType evtType = events[0].type();
+
+  const Event* first = events.begin();
+  while(first != events.end())
+  {
+    const Event* runLast = first + 1;
+    while((runLast != events.end()) && (runLast->tag() == first->tag()))
+    {
+      ++runLast;
+    }
+
+    auto it = _keyedHandlers.find(SubscriptionKey(evtType, first->tag()));
+    if((it != _keyedHandlers.cend()) && !it->second.typed)
+    {
+      it->second.handler->handleEvents(*this, EventSpan{first, runLast});
+    }
+
+    first = runLast;
+  }
+}
+
+namespace
+{
+  // Observer of a run loop without one
+  struct NoObserver
+  {
+    inline void operator () (SimEngine& sim, const Event& evt) const noexcept
+    {}
+  };
+
+  // Check a run loop observer before starting the loop
+  inline void CheckObserver(const SimEngine::EventObserver& observer)
+  {
+    if(!observer)
+    {
+      throw std::invalid_argument("Observer is empty");
+    }
+  }
+}
+
+template<typename Stop, typename Observe>
+size_t SimEngine::runLoop(Stop stop, Observe observe)
+{
+  if(_state != SimEngineState::Running)
+  {
+    throw std::runtime_error("Simulation is not Running");
+  }
+
+  size_t processed = 0;
+  try
+  {
+    while(!_schedule.empty() && !stop(processed))
+    {
+      Event evt = _schedule.getNext();
+
+      if(evt.time() < _time)
+      {
+        throw CausalityException(evt, "Event violates causality");
+      }
+
+      _time = evt.time();
+      dispatch(evt);
+      observe(*this, evt);
+      ++processed;
+    }
+  }
+  catch(const CausalityException&)
+  {
+    throw;
+  }
+  catch(...)
+  {
+    _state = SimEngineState::Error;
+    throw;
+  }
+
+  return processed;
+}
+
+size_t SimEngine::run()
+{
+  return runLoop([] (size_t) { return false; }, NoObserver{});
+}
+
+size_t SimEngine::run(const EventObserver& observer)
+{
+  CheckObserver(observer);
+  return runLoop([] (size_t) { return false; }, observer);
+}
+
+size_t SimEngine::runUntil(const SimTime stopTime)
+{
+  return runLoop([this, stopTime] (size_t) { return (_schedule.peekNext().time() > stopTime); }, NoObserver{});
+}
+
+size_t SimEngine::runUntil(const SimTime stopTime, const EventObserver& observer)
+{
+  CheckObserver(observer);
+  return runLoop([this, stopTime] (size_t) { return (_schedule.peekNext().time() > stopTime); }, observer);
+}
+
+size_t SimEngine::runFor(const size_t count)
+{
+  return runLoop([count] (size_t processed) { return (processed >= count); }, NoObserver{});
+}
+
+size_t SimEngine::runFor(const size_t count, const EventObserver& observer)
+{
+  CheckObserver(observer);
+  return runLoop([count] (size_t processed) { return (processed >= count); }, observer);
+}
+
 void SimEngine::finalize()
 {
   if(_state != SimEngineState::Running)
@@ -143,7 +753,7 @@ void SimEngine::finalize()
 
   try
   {
-    const auto& handlers = getAllHandlers();
+    const auto& handlers = orderedHandlers();
     for(auto handler : handlers)
     {
       assert(handler);
@@ -160,16 +770,316 @@ void SimEngine::finalize()
   }
 }
 
-std::set<EventHandler*> SimEngine::getAllHandlers() const
+std::vector<EventHandler*> SimEngine::dispatchOrder(const std::vector<EventHandler*>& handlers) const
 {
-  std::set<EventHandler*> handlers{};
+  std::vector<EventHandler*> ordered{handlers};
+  if(!_priorities.empty())
+  {
+    std::stable_sort(ordered.begin(), ordered.end(),
+      [this] (EventHandler* lhs, EventHandler* rhs) { return (handlerPriority(rhs) < handlerPriority(lhs)); });
+  }
+
+  return ordered;
+}
+
+void SimEngine::applyPendingChanges()
+{
+  assert(!_dispatching);
+
+  // Changes are applied outside dispatch, so they cannot queue further changes
+  try
+  {
+    for(size_t i = 0; i < _pendingChanges.size(); ++i)
+    {
+      const PendingChange& change = _pendingChanges[i];
+      switch(change.op)
+      {
+        case ChangeOp::Subscribe:
+          subscribe(change.handler);
+          break;
+
+        case ChangeOp::SubscribeType:
+          subscribe(change.handler, change.type);
+          break;
+
+        case ChangeOp::SubscribeKey:
+          subscribe(change.handler, change.type, change.tag);
+          break;
+
+        case ChangeOp::AddFilter:
+          addFilter(change.filter);
+          break;
+
+        case ChangeOp::Unsubscribe:
+          unsubscribe(change.handler);
+          break;
+
+        case ChangeOp::UnsubscribeType:
+          unsubscribe(change.handler, change.type);
+          break;
+
+        case ChangeOp::SetPriority:
+          setHandlerPriority(change.handler, change.priority);
+          break;
+
+        case ChangeOp::Initialize:
+          join(change.handler);
+          break;
+      }
+    }
+  }
+  catch(...)
+  {
+    _pendingChanges.clear();
+    _pendingKeys.clear();
+    throw;
+  }
+
+  _pendingChanges.clear();
+  _pendingKeys.clear();
+}
+
+void SimEngine::globalChanged()
+{
+  // The table is compiled from all subscriptions by initialize
+  if(!_dispatchStale)
+  {
+    _dispatch.updateGlobal(dispatchOrder(_globalHandlers));
+  }
+}
+
+void SimEngine::typeChanged(const EventType evtType)
+{
+  if(!_dispatchStale)
+  {
+    _dispatch.update(evtType, typeDispatchOrder(evtType));
+  }
+}
+
+void SimEngine::filterChanged(const TypeFilter& filter)
+{
+  if(_dispatchStale)
+  {
+    return;
+  }
+
+  // Types looked up by index are all in the table, larger types only once resolved
+  const EventType denseLast = std::min<EventType>(filter.last, DispatchTable::DenseLimit - 1);
+  for(EventType evtType = filter.first; evtType <= denseLast; ++evtType)
+  {
+    if(filter.matches(evtType))
+    {
+      _dispatch.update(evtType, typeDispatchOrder(evtType));
+    }
+  }
+
+  for(auto evtType : _dispatch.sparseTypes())
+  {
+    if(filter.matches(evtType))
+    {
+      _dispatch.update(evtType, typeDispatchOrder(evtType));
+    }
+  }
+}
+
+std::vector<SimEngine::TypeFilter> SimEngine::eraseFilters(EventHandler* handler)
+{
+  std::vector<TypeFilter> erased{};
+  auto it = std::stable_partition(_filters.begin(), _filters.end(),
+    [handler] (const TypeFilter& filter) { return (filter.handler != handler); });
+  erased.assign(it, _filters.end());
+  _filters.erase(it, _filters.end());
+
+  return erased;
+}
+
+void SimEngine::eraseTypeHandler(EventHandler* handler, const EventType evtType)
+{
+  auto it = _typeHandlers.find(evtType);
+  if((it != _typeHandlers.end()) && EraseHandler(it->second, handler) && it->second.empty())
+  {
+    _typeHandlers.erase(it);
+  }
+}
 
-  handlers.insert(_globalHandlers.cbegin(), _globalHandlers.cend());
+void SimEngine::keyedChanged(EventHandler* handler, const Subscriptions& subscriptions)
+{
+  for(auto key : subscriptions.keys)
+  {
+    _keyedHandlers[key].typed = subscribedTo(handler, subscriptions, (EventType)(key >> 32));
+  }
+}
+
+bool SimEngine::subscribedTo(EventHandler* handler, const Subscriptions& subscriptions, const EventType evtType) const
+{
+  if(std::find(subscriptions.types.cbegin(), subscriptions.types.cend(), evtType) != subscriptions.types.cend())
+  {
+    return true;
+  }
 
+  if(subscriptions.filters > 0)
+  {
+    for(const auto& filter : _filters)
+    {
+      if((filter.handler == handler) && filter.matches(evtType))
+      {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+SimEngine::Subscriptions& SimEngine::subscriptionsOf(EventHandler* handler, bool& joined)
+{
+  auto it = _subscriptions.find(handler);
+  joined = (it == _subscriptions.end());
+  if(joined)
+  {
+    it = _subscriptions.emplace(handler, Subscriptions{false, {}, {}, 0, Event::NoTarget}).first;
+  }
+
+  return it->second;
+}
+
+void SimEngine::join(EventHandler* handler)
+{
+  // Handlers subscribed before initialize are initialized with the simulation
+  if(_state == SimEngineState::Running)
+  {
+    try
+    {
+      handler->initialize(*this);
+    }
+    catch(...)
+    {
+      _state = SimEngineState::Error;
+      throw;
+    }
+  }
+}
+
+void SimEngine::leave(EventHandler* handler)
+{
+  if(_state == SimEngineState::Running)
+  {
+    try
+    {
+      handler->finalize(*this);
+    }
+    catch(...)
+    {
+      _state = SimEngineState::Error;
+      throw;
+    }
+  }
+}
+
+std::vector<EventHandler*> SimEngine::typeDispatchOrder(const EventType evtType) const
+{
+  std::vector<EventHandler*> handlers{};
+
+  auto it = _typeHandlers.find(evtType);
+  if(it != _typeHandlers.cend())
+  {
+    handlers = it->second;
+  }
+
+  for(const auto& filter : _filters)
+  {
+    if(filter.matches(evtType) && (std::find(handlers.cbegin(), handlers.cend(), filter.handler) == handlers.cend()))
+    {
+      handlers.push_back(filter.handler);
+    }
+  }
+
+  return dispatchOrder(handlers);
+}
+
+void SimEngine::compileDispatch()
+{
+  std::map<EventType, std::vector<EventHandler*>> typeHandlers{};
+  for(const auto& it : _typeHandlers)
+  {
+    typeHandlers[it.first] = typeDispatchOrder(it.first);
+  }
+
+  // Resolve type filters for all types looked up by index, larger types are resolved when first dispatched
+  if(!_filters.empty())
+  {
+    for(EventType evtType = 0; evtType < DispatchTable::DenseLimit; ++evtType)
+    {
+      if(typeHandlers.find(evtType) == typeHandlers.cend())
+      {
+        auto handlers = typeDispatchOrder(evtType);
+        if(!handlers.empty())
+        {
+          typeHandlers[evtType] = std::move(handlers);
+        }
+      }
+    }
+  }
+
+  _dispatch.compile(dispatchOrder(_globalHandlers), typeHandlers);
+  _dispatchStale = false;
+}
+
+std::vector<EventHandler*> SimEngine::orderedHandlers() const
+{
+  std::vector<EventHandler*> handlers{dispatchOrder(_globalHandlers)};
+  std::unordered_set<EventHandler*> listed{handlers.cbegin(), handlers.cend()};
   for(const auto& it : _typeHandlers)
   {
-    const auto& typeHandlers = it.second;
-    handlers.insert(typeHandlers.cbegin(), typeHandlers.cend());
+    for(auto handler : dispatchOrder(it.second))
+    {
+      if(listed.insert(handler).second)
+      {
+        handlers.push_back(handler);
+      }
+    }
+  }
+
+  for(const auto& filter : _filters)
+  {
+    if(listed.insert(filter.handler).second)
+    {
+      handlers.push_back(filter.handler);
+    }
+  }
+
+  for(auto handler : _targets)
+  {
+    if(handler && listed.insert(handler).second)
+    {
+      handlers.push_back(handler);
+    }
+  }
+
+  // Keyed handlers follow in key order, so the order does not depend on the hash map
+  std::map<uint64_t, EventHandler*> keyedHandlers{};
+  for(const auto& it : _keyedHandlers)
+  {
+    keyedHandlers[it.first] = it.second.handler;
+  }
+
+  for(const auto& it : keyedHandlers)
+  {
+    if(listed.insert(it.second).second)
+    {
+      handlers.push_back(it.second);
+    }
+  }
+
+  return handlers;
+}
+
+std::set<EventHandler*> SimEngine::getAllHandlers() const
+{
+  std::set<EventHandler*> handlers{};
+  for(const auto& it : _subscriptions)
+  {
+    handlers.insert(it.first);
   }
 
   return handlers;
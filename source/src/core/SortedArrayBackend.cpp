@@ -0,0 +1,70 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/SortedArrayBackend.h"
+#include <algorithm>
+
+namespace des
+{
+
+namespace
+{
+  // Sort events such that events with a smaller key are at the back
+  inline bool LaterThan(const KeyedEvent& lhs, const KeyedEvent& rhs) noexcept
+  { return (rhs.key < lhs.key); }
+}
+
+SortedArrayBackend::SortedArrayBackend() :
+  QueueBackend{},
+  _events{}
+{
+}
+
+SortedArrayBackend::~SortedArrayBackend()
+{
+}
+
+void SortedArrayBackend::insert(const Event& e, const EventKey& key)
+{
+  const KeyedEvent keyed{key, e};
+  auto it = std::lower_bound(_events.begin(), _events.end(), keyed, LaterThan);
+
+  _events.insert(it, keyed);
+}
+
+void SortedArrayBackend::appendUnordered(const Event& e, const EventKey& key)
+{
+  _events.push_back(KeyedEvent{key, e});
+}
+
+void SortedArrayBackend::restoreOrder(const size_t appended)
+{
+  // Sort the appended events and merge them with the sorted events
+  const auto middle = _events.end() - appended;
+  std::sort(middle, _events.end(), LaterThan);
+  std::inplace_merge(_events.begin(), middle, _events.end(), LaterThan);
+}
+
+void SortedArrayBackend::reserve(const size_t count)
+{
+  _events.reserve(count);
+}
+
+Event SortedArrayBackend::getNext()
+{
+  Event e = _events.back().event;
+  _events.pop_back();
+
+  return e;
+}
+
+const Event& SortedArrayBackend::peekNext() const
+{
+  return _events.back().event;
+}
+
+EventKey SortedArrayBackend::peekKey() const
+{
+  return _events.back().key;
+}
+
+} // End namespace
@@ -0,0 +1,229 @@
+#include "DESCommon.h"
+#include "core/Event.h"
+#include "core/TimingWheelBackend.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace des
+{
+
+namespace
+{
+  // Sort events such that events with a smaller key are at the top of the heap
+  inline bool LaterThan(const KeyedEvent& lhs, const KeyedEvent& rhs) noexcept
+  { return (rhs.key < lhs.key); }
+
+  // Index of the lowest set bit of a non-zero word
+  inline size_t LowestBit(uint64_t word) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    size_t index = 0;
+    while((word & 1) == 0)
+    {
+      word >>= 1;
+      ++index;
+    }
+    return index;
+#endif
+  }
+
+  // Index of the highest set bit of a non-zero word
+  inline size_t HighestBit(uint64_t word) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return std::numeric_limits<uint64_t>::digits - 1 - __builtin_clzll(word);
+#else
+    size_t index = 0;
+    while(word >>= 1)
+    {
+      ++index;
+    }
+    return index;
+#endif
+  }
+}
+
+constexpr unsigned TimingWheelBackend::SlotBits;
+constexpr size_t TimingWheelBackend::NumSlots;
+constexpr size_t TimingWheelBackend::NumLevels;
+constexpr size_t TimingWheelBackend::WordBits;
+constexpr size_t TimingWheelBackend::NumWords;
+
+TimingWheelBackend::TimingWheelBackend() :
+  QueueBackend{},
+  _now{0},
+  _early{},
+  _size{0}
+{
+  std::memset(_occupied, 0, sizeof(_occupied));
+}
+
+TimingWheelBackend::~TimingWheelBackend()
+{
+}
+
+size_t TimingWheelBackend::LevelIndex(const SimTime t, const SimTime now) noexcept
+{
+  const SimTime diff = t ^ now;
+  if(diff == 0)
+  {
+    return 0;
+  }
+
+  return HighestBit(diff) / SlotBits;
+}
+
+void TimingWheelBackend::insert(const Event& e, const EventKey& key)
+{
+  const KeyedEvent keyed{key, e};
+  if(e.time() < _now)
+  {
+    _early.push_back(keyed);
+    std::push_heap(_early.begin(), _early.end(), LaterThan);
+  }
+  else
+  {
+    place(keyed);
+  }
+
+  ++_size;
+}
+
+Event TimingWheelBackend::getNext()
+{
+  advance();
+
+  if(!_early.empty())
+  {
+    std::pop_heap(_early.begin(), _early.end(), LaterThan);
+    Event e = _early.back().event;
+    _early.pop_back();
+    --_size;
+
+    return e;
+  }
+
+  const size_t slot = SlotIndex(_now, 0);
+  auto& events = _slots[0][slot];
+
+  std::pop_heap(events.begin(), events.end(), LaterThan);
+  Event e = events.back().event;
+  events.pop_back();
+  if(events.empty())
+  {
+    _occupied[0][slot / WordBits] &= ~((uint64_t)1 << (slot % WordBits));
+  }
+
+  --_size;
+
+  return e;
+}
+
+const Event& TimingWheelBackend::peekNext() const
+{
+  advance();
+
+  if(!_early.empty())
+  {
+    return _early.front().event;
+  }
+
+  return _slots[0][SlotIndex(_now, 0)].front().event;
+}
+
+EventKey TimingWheelBackend::peekKey() const
+{
+  advance();
+
+  if(!_early.empty())
+  {
+    return _early.front().key;
+  }
+
+  return _slots[0][SlotIndex(_now, 0)].front().key;
+}
+
+void TimingWheelBackend::place(const KeyedEvent& e) const
+{
+  const size_t level = LevelIndex(e.key.time, _now);
+  const size_t slot = SlotIndex(e.key.time, level);
+
+  auto& events = _slots[level][slot];
+  events.push_back(e);
+
+  // Events in a level 0 slot share the same time, and are kept as a heap ordered by key
+  if(level == 0)
+  {
+    std::push_heap(events.begin(), events.end(), LaterThan);
+  }
+
+  _occupied[level][slot / WordBits] |= ((uint64_t)1 << (slot % WordBits));
+}
+
+size_t TimingWheelBackend::findSlot(const size_t level, const size_t from) const noexcept
+{
+  size_t word = from / WordBits;
+  uint64_t bits = _occupied[level][word] & (~(uint64_t)0 << (from % WordBits));
+
+  while(bits == 0)
+  {
+    if(++word >= NumWords)
+    {
+      return NumSlots;
+    }
+
+    bits = _occupied[level][word];
+  }
+
+  return (word * WordBits) + LowestBit(bits);
+}
+
+void TimingWheelBackend::advance() const
+{
+  assert(_size > 0);
+
+  if(!_early.empty())
+  {
+    return;
+  }
+
+  size_t level = 0;
+  while(level < NumLevels)
+  {
+    const size_t slot = findSlot(level, SlotIndex(_now, level));
+    if(slot == NumSlots)
+    {
+      ++level;
+      continue;
+    }
+
+    // Next event is in level 0, move wheel time up to it
+    if(level == 0)
+    {
+      _now = (_now & ~(SimTime)(NumSlots - 1)) | slot;
+      return;
+    }
+
+    // Move wheel time up to the earliest event in the slot and cascade the slot into lower levels
+    std::vector<KeyedEvent> events{};
+    events.swap(_slots[level][slot]);
+    _occupied[level][slot / WordBits] &= ~((uint64_t)1 << (slot % WordBits));
+
+    _now = std::min_element(events.cbegin(), events.cend(),
+      [] (const KeyedEvent& lhs, const KeyedEvent& rhs) { return (lhs.key.time < rhs.key.time); })->key.time;
+
+    for(const auto& e : events)
+    {
+      place(e);
+    }
+
+    level = 0;
+  }
+
+  assert(false);
+}
+
+} // End namespace
@@ -6,8 +6,9 @@
 namespace des
 {
 
-BinaryEventReader::BinaryEventReader(std::streambuf* buffer) :
-  EventReader{buffer}
+BinaryEventReader::BinaryEventReader(std::streambuf* buffer, const BinaryEventFormat format) :
+  EventReader{buffer},
+  _format{format}
 {
   if(!buffer)
   {
@@ -15,8 +16,9 @@ BinaryEventReader::BinaryEventReader(std::streambuf* buffer) :
   }
 }
 
-BinaryEventReader::BinaryEventReader(std::istream& str) :
-  EventReader{str}
+BinaryEventReader::BinaryEventReader(std::istream& str, const BinaryEventFormat format) :
+  EventReader{str},
+  _format{format}
 {
 }
 
@@ -26,13 +28,13 @@ BinaryEventReader::~BinaryEventReader()
 
 Event BinaryEventReader::read()
 {
-  static constexpr std::streamsize EVT_SIZE =
-    sizeof(SimTime) + sizeof(EventType) + sizeof(EventTag);
+  static constexpr std::streamsize MAX_EVT_SIZE =
+    sizeof(SimTime) + sizeof(EventType) + sizeof(EventTag) + sizeof(EventPriority) + sizeof(HandlerId);
 
-  char buffer[EVT_SIZE];
+  char buffer[MAX_EVT_SIZE];
   char* pBuffer = buffer;
 
-  _in.read(buffer, EVT_SIZE);
+  _in.read(buffer, BinaryEventSize(_format));
   if(!_in.good())
   {
     throw EventReadException{"Stream not good after read"};
@@ -47,7 +49,18 @@ Event BinaryEventReader::read()
   EventTag g = *(EventTag*)pBuffer;
   pBuffer += sizeof(EventTag);
 
-  return CreateEvent(t, n, g);
+  if(_format == BinaryEventFormat::V1)
+  {
+    return CreateEvent(t, n, g);
+  }
+
+  EventPriority p = *(EventPriority*)pBuffer;
+  pBuffer += sizeof(EventPriority);
+
+  HandlerId h = *(HandlerId*)pBuffer;
+  pBuffer += sizeof(HandlerId);
+
+  return CreateEvent(t, n, g, p, h);
 }
 
 } // End namespace
@@ -6,8 +6,9 @@
 namespace des
 {
 
-BinaryEventWriter::BinaryEventWriter(std::streambuf* buffer) :
-  EventWriter{buffer}
+BinaryEventWriter::BinaryEventWriter(std::streambuf* buffer, const BinaryEventFormat format) :
+  EventWriter{buffer},
+  _format{format}
 {
   if(!buffer)
   {
@@ -15,8 +16,9 @@ BinaryEventWriter::BinaryEventWriter(std::streambuf* buffer) :
   }
 }
 
-BinaryEventWriter::BinaryEventWriter(std::ostream& str) :
-  EventWriter{str}
+BinaryEventWriter::BinaryEventWriter(std::ostream& str, const BinaryEventFormat format) :
+  EventWriter{str},
+  _format{format}
 {
 }
 
@@ -26,10 +28,15 @@ BinaryEventWriter::~BinaryEventWriter()
 
 void BinaryEventWriter::write(const Event& e)
 {
-  static constexpr std::streamsize EVT_SIZE =
-    sizeof(SimTime) + sizeof(EventType) + sizeof(EventTag);
+  static constexpr std::streamsize MAX_EVT_SIZE =
+    sizeof(SimTime) + sizeof(EventType) + sizeof(EventTag) + sizeof(EventPriority) + sizeof(HandlerId);
 
-  char buffer[EVT_SIZE];
+  if((_format == BinaryEventFormat::V1) && ((e.priority() != 0) || (e.target() != Event::NoTarget)))
+  {
+    throw EventWriteException{"V1 format can't hold event priority or target"};
+  }
+
+  char buffer[MAX_EVT_SIZE];
   char* pBuffer = buffer;
 
   *(SimTime*)pBuffer = e.time();
@@ -41,7 +48,16 @@ void BinaryEventWriter::write(const Event& e)
   *(EventTag*)pBuffer = e.tag();
   pBuffer += sizeof(EventTag);
 
-  _out.write(buffer, EVT_SIZE);
+  if(_format == BinaryEventFormat::V2)
+  {
+    *(EventPriority*)pBuffer = e.priority();
+    pBuffer += sizeof(EventPriority);
+
+    *(HandlerId*)pBuffer = e.target();
+    pBuffer += sizeof(HandlerId);
+  }
+
+  _out.write(buffer, pBuffer - buffer);
   if(!_out.good())
   {
     throw EventWriteException{"Stream not good after write"};
@@ -32,6 +32,7 @@ Event JsonEventReader::read()
   SimTime t;
   EventType n;
   EventTag g;
+  EventPriority p;
 
   // Read JSON object from stream
   try
@@ -61,7 +62,11 @@ Event JsonEventReader::read()
   it = obj.find("tag");
   g = (it != end) ? *it : throw EventReadException{"JSON object missing tag"};
 
-  return CreateEvent(t, n, g);
+  // Priority is optional
+  it = obj.find("priority");
+  p = (it != end) ? (EventPriority)*it : 0;
+
+  return CreateEvent(t, n, g, p);
 }
 
 } // End namespace
@@ -34,6 +34,12 @@ void JsonEventWriter::write(const Event& e)
     obj["time"] = e.time();
     obj["type"] = e.type();
     obj["tag"] = e.tag();
+
+    // Priority is only written when set
+    if(e.priority() != 0)
+    {
+      obj["priority"] = e.priority();
+    }
   }
   catch(const std::exception& ex)
   {
@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/AdaptiveBackend.h"
+#include <random>
+
+using namespace des;
+
+namespace _testAdaptiveBackend
+{
+  // Repeatedly remove the next event and schedule another after an increment, checking order
+  template<typename Increment>
+  void Hold(AdaptiveBackend& q, Increment increment, const size_t count)
+  {
+    SimTime now = 0;
+    for(size_t i = 0; i < count; ++i)
+    {
+      Event e = q.getNext();
+      ASSERT_LE(now, e.time());
+      now = e.time();
+
+      q.insert(Event{now + increment(), 0});
+    }
+  }
+}
+using namespace _testAdaptiveBackend;
+
+TEST(testAdaptiveBackend, ctor)
+{
+  AdaptiveBackend q{};
+
+  EXPECT_EQ(0, q.size());
+  EXPECT_EQ(AdaptiveBackend::Structure::SortedArray, q.structure());
+}
+
+TEST(testAdaptiveBackend, grow)
+{
+  AdaptiveBackend q{};
+
+  // Sorted array is left once it holds twice its limit
+  for(SimTime t = 2 * AdaptiveBackend::SmallLimit; t > 0; --t)
+  {
+    q.insert(Event{t, 0});
+  }
+  EXPECT_EQ(AdaptiveBackend::Structure::SortedArray, q.structure());
+
+  q.insert(Event{0, 0});
+  EXPECT_EQ(AdaptiveBackend::Structure::Heap, q.structure());
+
+  // Order is preserved by the migration
+  for(SimTime t = 0; t <= 2 * AdaptiveBackend::SmallLimit; ++t)
+  {
+    ASSERT_EQ(t, q.getNext().time());
+  }
+}
+
+TEST(testAdaptiveBackend, buckets)
+{
+  AdaptiveBackend q{};
+  std::default_random_engine rng{1234};
+  std::uniform_int_distribution<SimTime> dist{1, 10000};
+
+  for(size_t i = 0; i < 2 * AdaptiveBackend::BucketLimit; ++i)
+  {
+    q.insert(Event{dist(rng), 0});
+  }
+  EXPECT_EQ(AdaptiveBackend::Structure::Heap, q.structure());
+
+  // Many events with regular increments move to buckets
+  Hold(q, [&] () { return dist(rng); }, 2 * AdaptiveBackend::SampleInterval);
+  EXPECT_EQ(AdaptiveBackend::Structure::Buckets, q.structure());
+
+  // Draining returns to the heap, then to the sorted array
+  SimTime now = 0;
+  bool heap = false;
+  while(q.size() > 0)
+  {
+    heap = heap || (q.structure() == AdaptiveBackend::Structure::Heap);
+
+    Event e = q.getNext();
+    ASSERT_LE(now, e.time());
+    now = e.time();
+  }
+
+  EXPECT_TRUE(heap);
+  EXPECT_EQ(AdaptiveBackend::Structure::SortedArray, q.structure());
+}
+
+TEST(testAdaptiveBackend, irregular)
+{
+  AdaptiveBackend q{};
+  std::default_random_engine rng{5678};
+  std::uniform_int_distribution<int> dist{0, 99};
+
+  for(size_t i = 0; i < 2 * AdaptiveBackend::BucketLimit; ++i)
+  {
+    q.insert(Event{(SimTime)dist(rng), 0});
+  }
+
+  // Mostly short increments with rare very long ones stay in the heap
+  Hold(q, [&] () { return (dist(rng) == 0) ? (SimTime)1000000000 : (SimTime)1; }, 4 * AdaptiveBackend::SampleInterval);
+  EXPECT_EQ(AdaptiveBackend::Structure::Heap, q.structure());
+}
@@ -0,0 +1,262 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/BinaryHeapBackend.h"
+#include "core/EventQueue.h"
+#include "core/BackendQueue.h"
+#include "core/StaticDispatch.h"
+#include "core/BasicSimEngine.h"
+#include <stdexcept>
+#include <vector>
+
+using namespace des;
+
+namespace _testBasicSimEngine
+{
+  // Handlers share a log of (handler id, event type) so dispatch order can be checked
+  typedef std::vector<std::pair<int, EventType>> CallLog;
+
+  struct Counter
+  {
+    Counter(const int id, CallLog& log) :
+      id{id}, log(log), initialized{0}, finalized{0}
+    {}
+
+    template<typename Engine>
+    void handleEvent(Engine& sim, const Event& evt)
+    { log.push_back(std::make_pair(id, evt.type())); }
+
+    template<typename Engine>
+    void initialize(Engine& sim)
+    { ++initialized; }
+
+    template<typename Engine>
+    void finalize(Engine& sim)
+    { ++finalized; }
+
+    int id;
+    CallLog& log;
+    int initialized;
+    int finalized;
+  };
+
+  // Schedules a follow-up event of type 2 one time unit after each event of type 1
+  struct Chainer
+  {
+    explicit Chainer(CallLog& log) :
+      log(log)
+    {}
+
+    template<typename Engine>
+    void handleEvent(Engine& sim, const Event& evt)
+    {
+      log.push_back(std::make_pair(-1, evt.type()));
+      if(evt.type() == 1)
+      {
+        sim.insertEvent(evt.time() + 1, 2);
+      }
+    }
+
+    template<typename Engine>
+    void initialize(Engine& sim)
+    {}
+
+    template<typename Engine>
+    void finalize(Engine& sim)
+    {}
+
+    CallLog& log;
+  };
+
+  struct Thrower
+  {
+    template<typename Engine>
+    void handleEvent(Engine& sim, const Event& evt)
+    { throw std::runtime_error("Handler failed"); }
+
+    template<typename Engine>
+    void initialize(Engine& sim)
+    {}
+
+    template<typename Engine>
+    void finalize(Engine& sim)
+    {}
+  };
+
+  typedef StaticDispatch<Counter, Chainer, Thrower> Dispatch;
+  typedef BasicSimEngine<BackendQueue<BinaryHeapBackend>, Dispatch> StaticEngine;
+  typedef BasicSimEngine<EventQueue, Dispatch> QueueEngine;
+
+  // Run loops stop at the stop time or count, calling the observer with each event
+  template<typename Engine>
+  void CheckRun()
+  {
+    CallLog log{};
+    Counter counter{1, log};
+
+    Engine sim{};
+    sim.subscribe(&counter);
+    ASSERT_THROW(sim.run(), std::runtime_error);
+
+    for(SimTime t = 1; t <= 10; ++t)
+    {
+      sim.insertEvent(t, (EventType)t);
+    }
+    sim.initialize();
+
+    std::vector<SimTime> observed{};
+    auto observer = [&observed] (Engine& engine, const Event& evt) { observed.push_back(evt.time()); };
+
+    EXPECT_EQ(3, sim.runFor(3));
+    EXPECT_EQ(3, sim.time());
+    EXPECT_EQ(0, sim.runFor(0));
+
+    EXPECT_EQ(3, sim.runUntil(6, observer));
+    EXPECT_EQ(6, sim.time());
+    EXPECT_EQ((std::vector<SimTime>{4, 5, 6}), observed);
+
+    EXPECT_EQ(0, sim.runUntil(6));
+    EXPECT_EQ(2, sim.runFor(2, observer));
+    EXPECT_EQ(2, sim.run(observer));
+    EXPECT_EQ(10, sim.time());
+    EXPECT_EQ(0, sim.run());
+    EXPECT_EQ(7, observed.size());
+    EXPECT_EQ(10, log.size());
+  }
+}
+using namespace _testBasicSimEngine;
+
+TEST(testBasicSimEngine, ctor)
+{
+  StaticEngine sim{};
+
+  ASSERT_FALSE(sim.hasNextEvent());
+  ASSERT_EQ(0, sim.eventCount());
+  ASSERT_EQ(0, sim.time());
+  ASSERT_EQ(SimEngineState::Uninitialized, sim.state());
+}
+
+TEST(testBasicSimEngine, dispatch)
+{
+  CallLog log{};
+  Counter global{1, log};
+  Counter typed{2, log};
+  Counter later{3, log};
+  Chainer chainer{log};
+
+  StaticEngine sim{};
+  sim.subscribe(&typed, 2);
+  sim.subscribe(&global);
+  sim.subscribe(&chainer, 1);
+  sim.subscribe(&later, 2);
+  ASSERT_THROW(sim.subscribe((Counter*)nullptr), std::invalid_argument);
+
+  sim.insertEvent(1, 1);
+  sim.insertEvent(5, 3);
+
+  ASSERT_NO_THROW(sim.initialize());
+  EXPECT_EQ(SimEngineState::Running, sim.state());
+  EXPECT_EQ(1, global.initialized);
+  EXPECT_EQ(1, typed.initialized);
+  EXPECT_EQ(1, later.initialized);
+  ASSERT_THROW(sim.subscribe(&global), std::runtime_error);
+  ASSERT_THROW(sim.initialize(), std::runtime_error);
+
+  // Global handlers first, then type handlers in subscription order
+  ASSERT_EQ(3, sim.run());
+  EXPECT_EQ(5, sim.time());
+  EXPECT_FALSE(sim.hasNextEvent());
+
+  const CallLog expected{{1, 1}, {-1, 1}, {1, 2}, {2, 2}, {3, 2}, {1, 3}};
+  EXPECT_EQ(expected, log);
+
+  ASSERT_NO_THROW(sim.finalize());
+  EXPECT_EQ(SimEngineState::Finalized, sim.state());
+  EXPECT_EQ(1, global.finalized);
+  EXPECT_EQ(1, later.finalized);
+  ASSERT_THROW(sim.finalize(), std::runtime_error);
+}
+
+TEST(testBasicSimEngine, resubscribe)
+{
+  CallLog log{};
+  Counter first{1, log};
+  Counter second{2, log};
+
+  StaticEngine sim{};
+  sim.subscribe(&first, 1);
+  sim.subscribe(&second, 1);
+  sim.subscribe(&first, 1);
+  sim.subscribe(&second);
+  sim.subscribe(&second);
+
+  sim.insertEvent(1, 1);
+  sim.insertEvent(2, 2);
+  sim.initialize();
+  sim.run();
+
+  const CallLog expected{{2, 1}, {1, 1}, {2, 2}};
+  EXPECT_EQ(expected, log);
+  EXPECT_EQ(1, second.initialized);
+}
+
+TEST(testBasicSimEngine, step)
+{
+  CallLog log{};
+  Counter counter{1, log};
+
+  StaticEngine sim{};
+  sim.subscribe(&counter);
+
+  sim.insertEvent(2, 20);
+  sim.insertEvent(1, 10);
+
+  ASSERT_THROW(sim.step(), std::runtime_error);
+  sim.initialize();
+
+  Event evt = sim.step();
+  EXPECT_EQ(1, evt.time());
+  EXPECT_EQ(10, evt.type());
+  EXPECT_EQ(1, sim.time());
+
+  evt = sim.step();
+  EXPECT_EQ(2, evt.time());
+  EXPECT_EQ(20, evt.type());
+
+  ASSERT_THROW(sim.step(), std::runtime_error);
+  EXPECT_EQ(SimEngineState::Running, sim.state());
+  EXPECT_EQ(2, log.size());
+}
+
+TEST(testBasicSimEngine, run)
+{
+  CheckRun<StaticEngine>();
+  CheckRun<QueueEngine>();
+}
+
+TEST(testBasicSimEngine, errors)
+{
+  Thrower thrower{};
+
+  StaticEngine sim{};
+  sim.subscribe(&thrower, 2);
+  sim.insertEvent(2, 1);
+  sim.insertEvent(1, 1);
+  sim.initialize();
+
+  // Causality violations leave the simulation running
+  sim.step();
+  sim.insertEvent(0, 1);
+  ASSERT_THROW(sim.run(), CausalityException);
+  EXPECT_EQ(SimEngineState::Running, sim.state());
+
+  // Addressed events are rejected rather than passed to every handler of the type
+  ASSERT_THROW(sim.insertEvent(Event{3, 2, 0, 0, 1}), std::logic_error);
+  EXPECT_EQ(SimEngineState::Running, sim.state());
+
+  // Handler errors put the simulation in the error state
+  sim.insertEvent(3, 2);
+  ASSERT_THROW(sim.run(), std::runtime_error);
+  EXPECT_EQ(SimEngineState::Error, sim.state());
+  ASSERT_THROW(sim.run(), std::runtime_error);
+  ASSERT_THROW(sim.finalize(), std::runtime_error);
+}
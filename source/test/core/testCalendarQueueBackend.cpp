@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/CalendarQueueBackend.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace des;
+
+TEST(testCalendarQueueBackend, ctor)
+{
+  CalendarQueueBackend q{};
+
+  EXPECT_EQ(0, q.size());
+  EXPECT_EQ(2, q.bucketCount());
+  EXPECT_EQ(1, q.bucketWidth());
+}
+
+TEST(testCalendarQueueBackend, resize)
+{
+  CalendarQueueBackend q{};
+  std::default_random_engine rng{1234};
+  std::uniform_int_distribution<SimTime> dist{0, 10000};
+
+  // Insert events in random order
+  std::vector<SimTime> times{};
+  for(int i = 0; i < 1000; ++i)
+  {
+    SimTime t = dist(rng);
+    times.push_back(t);
+    q.insert(Event{t, (EventType)i});
+    ASSERT_EQ(times.size(), q.size());
+  }
+
+  // Calendar should have grown
+  EXPECT_GE(q.bucketCount(), 256);
+  EXPECT_GT(q.bucketWidth(), 1);
+
+  // Events should be returned in ascending time order
+  std::sort(times.begin(), times.end());
+  for(auto t : times)
+  {
+    ASSERT_EQ(t, q.peekNext().time());
+    ASSERT_EQ(t, q.getNext().time());
+  }
+
+  // Calendar should have shrunk
+  EXPECT_EQ(0, q.size());
+  EXPECT_EQ(2, q.bucketCount());
+}
+
+TEST(testCalendarQueueBackend, sparse)
+{
+  CalendarQueueBackend q{};
+
+  // Events far apart require a direct search
+  q.insert(Event{1000000, 1});
+  q.insert(Event{5, 2});
+  q.insert(Event{1000000000, 3});
+
+  EXPECT_EQ(5, q.getNext().time());
+  EXPECT_EQ(1000000, q.getNext().time());
+
+  // Insert an event earlier than the search position
+  q.insert(Event{6, 4});
+  EXPECT_EQ(6, q.peekNext().time());
+  EXPECT_EQ(4, q.getNext().type());
+  EXPECT_EQ(1000000000, q.getNext().time());
+  EXPECT_EQ(0, q.size());
+}
+
+TEST(testCalendarQueueBackend, sameTime)
+{
+  CalendarQueueBackend q{};
+
+  for(int i = 0; i < 100; ++i)
+  {
+    q.insert(Event{42, (EventType)i});
+  }
+
+  for(int i = 0; i < 100; ++i)
+  {
+    ASSERT_EQ(42, q.getNext().time());
+  }
+
+  EXPECT_EQ(0, q.size());
+}
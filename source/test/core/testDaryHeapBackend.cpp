@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/DaryHeapBackend.h"
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace des;
+
+namespace _testDaryHeapBackend
+{
+  // Ties between children are broken by priority, then insertion order
+  template<typename Backend>
+  void checkTies()
+  {
+    Backend q{};
+    std::default_random_engine rng{4321};
+    std::uniform_int_distribution<SimTime> timeDist{0, 7};
+    std::uniform_int_distribution<EventPriority> priorityDist{0, 3};
+
+    // Few distinct times, half of them with the top bit set, so most children tie
+    std::vector<std::tuple<SimTime, int, EventTag>> expected{};
+    for(EventTag i = 0; i < 2000; ++i)
+    {
+      const SimTime t = (timeDist(rng) < 4) ? timeDist(rng) : (UINT64_MAX - timeDist(rng));
+      const EventPriority priority = priorityDist(rng);
+      expected.push_back(std::make_tuple(t, -(int)priority, i));
+      q.insert(Event{t, 0, i, priority});
+    }
+
+    std::sort(expected.begin(), expected.end());
+    for(const auto& e : expected)
+    {
+      Event evt = q.getNext();
+      ASSERT_EQ(std::get<0>(e), evt.time());
+      ASSERT_EQ(std::get<2>(e), evt.tag());
+    }
+
+    EXPECT_EQ(0, q.size());
+  }
+}
+using namespace _testDaryHeapBackend;
+
+TEST(testDaryHeapBackend, ties)
+{
+  checkTies<QuaternaryHeapBackend>();
+  checkTies<OctonaryHeapBackend>();
+}
+
+TEST(testDaryHeapBackend, extremes)
+{
+  OctonaryHeapBackend q{};
+
+  // Maximum time must not be confused with unused entries
+  q.insert(Event{UINT64_MAX, 1});
+  q.insert(Event{UINT64_MAX, 2});
+  q.insert(Event{0, 3});
+
+  EXPECT_EQ(3, q.getNext().type());
+  EXPECT_EQ(UINT64_MAX, q.getNext().time());
+  EXPECT_EQ(UINT64_MAX, q.getNext().time());
+  EXPECT_EQ(0, q.size());
+}
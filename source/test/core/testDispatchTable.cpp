@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/EventHandler.h"
+#include "core/DispatchTable.h"
+#include "core/SimEngine.h"
+#include <map>
+#include <vector>
+
+using namespace des;
+
+namespace _testDispatchTable
+{
+  class NullHandler : public EventHandler
+  {
+  public:
+    void handleEvent(SimEngine& sim, const Event& evt) override
+    {}
+
+    void initialize(SimEngine& sim) override
+    {}
+
+    void finalize(SimEngine& sim) override
+    {}
+  };
+
+  // Handlers of a run as a vector
+  inline std::vector<EventHandler*> ToVector(const DispatchTable::Handlers& handlers)
+  { return std::vector<EventHandler*>(handlers.begin(), handlers.end()); }
+}
+using namespace _testDispatchTable;
+
+TEST(testDispatchTable, empty)
+{
+  DispatchTable table{};
+  EXPECT_EQ(0, table.find(0).size());
+  EXPECT_EQ(0, table.find(DispatchTable::DenseLimit + 5).size());
+
+  table.compile(std::vector<EventHandler*>{}, std::map<EventType, std::vector<EventHandler*>>{});
+  EXPECT_EQ(0, table.find(7).size());
+}
+
+TEST(testDispatchTable, compile)
+{
+  NullHandler h1{};
+  NullHandler h2{};
+  NullHandler h3{};
+
+  const std::vector<EventHandler*> global{&h1};
+  std::map<EventType, std::vector<EventHandler*>> typed{};
+  typed[2] = {&h3, &h2};
+  typed[5] = {&h3};
+  typed[DispatchTable::DenseLimit + 10] = {&h2};
+  typed[9];
+
+  DispatchTable table{};
+  table.compile(global, typed);
+
+  // Global handlers come first, followed by the type handlers in the given order
+  EXPECT_EQ((std::vector<EventHandler*>{&h1, &h3, &h2}), ToVector(table.find(2)));
+
+  EXPECT_EQ((std::vector<EventHandler*>{&h1, &h3}), ToVector(table.find(5)));
+  EXPECT_EQ((std::vector<EventHandler*>{&h1, &h2}), ToVector(table.find(DispatchTable::DenseLimit + 10)));
+
+  // Unsubscribed types get only the global handlers
+  for(EventType type : {(EventType)0, (EventType)3, (EventType)9, (EventType)100, DispatchTable::DenseLimit + 11})
+  {
+    EXPECT_EQ((std::vector<EventHandler*>{&h1}), ToVector(table.find(type)));
+  }
+
+  // Recompiling replaces the table
+  table.compile(std::vector<EventHandler*>{}, std::map<EventType, std::vector<EventHandler*>>{{5, {&h2}}});
+  EXPECT_EQ(0, table.find(2).size());
+  EXPECT_EQ((std::vector<EventHandler*>{&h2}), ToVector(table.find(5)));
+  EXPECT_EQ(0, table.find(DispatchTable::DenseLimit + 10).size());
+}
+
+TEST(testDispatchTable, resolve)
+{
+  NullHandler g{};
+  NullHandler h1{};
+  NullHandler h2{};
+
+  DispatchTable table{};
+  table.compile(std::vector<EventHandler*>{&g}, std::map<EventType, std::vector<EventHandler*>>{});
+
+  const EventType sparse = DispatchTable::DenseLimit + 5;
+  EXPECT_TRUE(table.resolved(0));
+  EXPECT_TRUE(table.resolved(DispatchTable::DenseLimit - 1));
+  EXPECT_FALSE(table.resolved(sparse));
+
+  table.resolve(sparse, std::vector<EventHandler*>{&h1, &h2});
+  EXPECT_TRUE(table.resolved(sparse));
+  EXPECT_EQ((std::vector<EventHandler*>{&g, &h1, &h2}), ToVector(table.find(sparse)));
+
+  // Types without handlers of their own are not stored
+  table.resolve(sparse + 1, std::vector<EventHandler*>{});
+  EXPECT_FALSE(table.resolved(sparse + 1));
+  EXPECT_EQ((std::vector<EventHandler*>{&g}), ToVector(table.find(sparse + 1)));
+
+  // Compiling drops resolved types
+  table.compile(std::vector<EventHandler*>{&g}, std::map<EventType, std::vector<EventHandler*>>{});
+  EXPECT_FALSE(table.resolved(sparse));
+}
+
+TEST(testDispatchTable, update)
+{
+  NullHandler g{};
+  NullHandler h1{};
+  NullHandler h2{};
+
+  const EventType sparse = DispatchTable::DenseLimit + 5;
+
+  DispatchTable table{};
+  std::map<EventType, std::vector<EventHandler*>> typeHandlers{};
+  typeHandlers[3] = std::vector<EventHandler*>{&h1};
+  typeHandlers[sparse] = std::vector<EventHandler*>{&h1};
+  table.compile(std::vector<EventHandler*>{&g}, typeHandlers);
+
+  table.update(3, std::vector<EventHandler*>{&h1, &h2});
+  table.update(10, std::vector<EventHandler*>{&h2});
+  table.update(sparse, std::vector<EventHandler*>{&h2});
+  table.update(sparse + 1, std::vector<EventHandler*>{&h1});
+
+  EXPECT_EQ((std::vector<EventHandler*>{&g, &h1, &h2}), ToVector(table.find(3)));
+  EXPECT_EQ((std::vector<EventHandler*>{&g, &h2}), ToVector(table.find(10)));
+  EXPECT_EQ((std::vector<EventHandler*>{&g}), ToVector(table.find(7)));
+  EXPECT_EQ((std::vector<EventHandler*>{&g, &h2}), ToVector(table.find(sparse)));
+  EXPECT_EQ((std::vector<EventHandler*>{&g, &h1}), ToVector(table.find(sparse + 1)));
+
+  // Repeated updates compact the table without disturbing other types
+  for(int i = 0; i < 100; ++i)
+  {
+    table.update(3, (i % 2) ? std::vector<EventHandler*>{&h2} : std::vector<EventHandler*>{});
+    ASSERT_EQ((std::vector<EventHandler*>{&g, &h2}), ToVector(table.find(10)));
+    ASSERT_EQ((std::vector<EventHandler*>{&g, &h2}), ToVector(table.find(sparse)));
+    ASSERT_EQ((std::vector<EventHandler*>{&g}), ToVector(table.find(7)));
+  }
+
+  EXPECT_EQ((std::vector<EventHandler*>{&g, &h2}), ToVector(table.find(3)));
+
+  table.update(sparse, std::vector<EventHandler*>{});
+  EXPECT_EQ((std::vector<EventHandler*>{&g}), ToVector(table.find(sparse)));
+}
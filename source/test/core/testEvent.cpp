@@ -31,3 +31,34 @@ TEST(testEvent, ctor)
   EXPECT_EQ(78, e2.type());
   EXPECT_EQ(0, e2.tag());
 }
+
+TEST(testEvent, priority)
+{
+  Event e1{12, 34};
+  Event e2{12, 34, 56, 78};
+
+  EXPECT_EQ(0, e1.priority());
+
+  EXPECT_EQ(12, e2.time());
+  EXPECT_EQ(34, e2.type());
+  EXPECT_EQ(56, e2.tag());
+  EXPECT_EQ(78, e2.priority());
+
+  Event e3 = e2;
+  EXPECT_EQ(78, e3.priority());
+}
+
+TEST(testEvent, target)
+{
+  Event e1{12, 34};
+  Event e2{12, 34, 56, 78, 9};
+
+  EXPECT_EQ(Event::NoTarget, e1.target());
+  EXPECT_EQ(9, e2.target());
+
+  Event e3 = e2;
+  EXPECT_EQ(9, e3.target());
+
+  // Target fits in the padding after the priority
+  EXPECT_EQ(sizeof(Event{0, 0}), 2 * sizeof(SimTime) + 2 * sizeof(EventType));
+}
@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/EventHandle.h"
+#include "core/EventQueue.h"
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace des;
+
+TEST(testEventHandle, ctor)
+{
+  EventHandle h{};
+
+  EXPECT_EQ(nullptr, h.queue());
+  EXPECT_FALSE(h.pending());
+  EXPECT_FALSE(h.cancel());
+  EXPECT_FALSE(h.reschedule(10));
+}
+
+TEST(testEventHandle, cancel)
+{
+  EventQueue q{};
+
+  EventHandle h1 = q.insertWithHandle(Event{10, 1});
+  EventHandle h2 = q.insertWithHandle(20, 2);
+  EventHandle h3 = q.insertWithHandle(30, 3, 300);
+  q.insert(Event{25, 4});
+
+  EXPECT_EQ(&q, h1.queue());
+  EXPECT_TRUE(h1.pending());
+  EXPECT_TRUE(h2.pending());
+  EXPECT_TRUE(h3.pending());
+  EXPECT_EQ(4, q.size());
+
+  // Cancel an event in the middle of the queue
+  EXPECT_TRUE(h2.cancel());
+  EXPECT_FALSE(h2.pending());
+  EXPECT_EQ(3, q.size());
+
+  // Cancel again has no effect
+  EXPECT_FALSE(h2.cancel());
+  EXPECT_FALSE(q.cancel(h2));
+  EXPECT_EQ(3, q.size());
+
+  // Handle no longer refers to an event once it is removed
+  EXPECT_EQ(10, q.getNext().time());
+  EXPECT_FALSE(h1.pending());
+  EXPECT_FALSE(h1.cancel());
+
+  // Slot reused by a new event is not affected by old handles
+  EventHandle h4 = q.insertWithHandle(Event{40, 5});
+  EXPECT_FALSE(h1.pending());
+  EXPECT_FALSE(h2.pending());
+  EXPECT_TRUE(h4.pending());
+
+  EXPECT_EQ(4, q.getNext().type());
+  EXPECT_EQ(3, q.getNext().type());
+  EXPECT_EQ(5, q.getNext().type());
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(testEventHandle, reschedule)
+{
+  EventQueue q{};
+
+  EventHandle h1 = q.insertWithHandle(Event{10, 1, 100});
+  EventHandle h2 = q.insertWithHandle(Event{20, 2, 200});
+  q.insert(Event{30, 3, 300});
+
+  // Move first event later
+  EXPECT_TRUE(h1.reschedule(35));
+  EXPECT_TRUE(h1.pending());
+  EXPECT_EQ(3, q.size());
+  EXPECT_EQ(20, q.peekNext().time());
+
+  // Move second event earlier
+  EXPECT_TRUE(q.reschedule(h2, 5));
+  EXPECT_EQ(5, q.peekNext().time());
+
+  Event e = q.getNext();
+  EXPECT_EQ(5, e.time());
+  EXPECT_EQ(2, e.type());
+  EXPECT_EQ(200, e.tag());
+  EXPECT_FALSE(h2.reschedule(50));
+
+  EXPECT_EQ(30, q.getNext().time());
+
+  e = q.getNext();
+  EXPECT_EQ(35, e.time());
+  EXPECT_EQ(1, e.type());
+  EXPECT_EQ(100, e.tag());
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(testEventHandle, foreignQueue)
+{
+  EventQueue q1{};
+  EventQueue q2{};
+
+  EventHandle h = q1.insertWithHandle(Event{10, 1});
+  ASSERT_THROW(q2.cancel(h), std::invalid_argument);
+  ASSERT_THROW(q2.reschedule(h, 20), std::invalid_argument);
+  ASSERT_THROW(q2.pending(h), std::invalid_argument);
+  EXPECT_TRUE(h.pending());
+}
+
+TEST(testEventHandle, unsupported)
+{
+  EventQueue q{QueueBackendType::CalendarQueue};
+
+  EXPECT_FALSE(q.supportsHandles());
+  ASSERT_THROW(q.insertWithHandle(Event{10, 1}), std::logic_error);
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(testEventHandle, random)
+{
+  EventQueue q{};
+  std::default_random_engine rng{1234};
+  std::uniform_int_distribution<SimTime> dist{0, 1000};
+
+  // Reference of pending events by tag
+  std::map<EventTag, SimTime> expected{};
+  std::vector<EventHandle> handles{};
+
+  for(EventTag i = 0; i < 1000; ++i)
+  {
+    SimTime t = dist(rng);
+    handles.push_back(q.insertWithHandle(Event{t, 0, i}));
+    expected[i] = t;
+  }
+
+  // Cancel and reschedule random events
+  for(EventTag i = 0; i < 1000; i += 3)
+  {
+    EXPECT_TRUE(handles[i].cancel());
+    expected.erase(i);
+  }
+
+  for(EventTag i = 1; i < 1000; i += 3)
+  {
+    SimTime t = dist(rng);
+    EXPECT_TRUE(handles[i].reschedule(t));
+    expected[i] = t;
+  }
+
+  ASSERT_EQ(expected.size(), q.size());
+
+  // Events should be returned in ascending time order with their final times
+  SimTime last = 0;
+  while(!q.empty())
+  {
+    Event e = q.getNext();
+    ASSERT_LE(last, e.time());
+    ASSERT_EQ(expected[e.tag()], e.time());
+    EXPECT_FALSE(handles[e.tag()].pending());
+    last = e.time();
+  }
+}
@@ -1,9 +1,29 @@
 #include "gtest/gtest.h"
 #include "core/Event.h"
 #include "core/EventQueue.h"
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
 
 using namespace des;
 
+// Ordering checks shared by every backend, run on the backend on its own
+class testQueueBackend : public ::testing::TestWithParam<QueueBackendType>
+{
+protected:
+  std::unique_ptr<QueueBackend> createBackend() const
+  { return EventQueue::CreateBackend(GetParam()); }
+};
+
+INSTANTIATE_TEST_SUITE_P(backends, testQueueBackend, ::testing::Values(QueueBackendType::BinaryHeap,
+  QueueBackendType::CalendarQueue, QueueBackendType::RadixHeap, QueueBackendType::TimingWheel,
+  QueueBackendType::LadderQueue, QueueBackendType::QuaternaryHeap, QueueBackendType::OctonaryHeap,
+  QueueBackendType::SortedArray, QueueBackendType::Adaptive, QueueBackendType::Partitioned));
+
 TEST(testEventQueue, ctor)
 {
   ASSERT_NO_THROW(EventQueue{});
@@ -244,3 +264,388 @@ TEST(testEventQueue, orderEvent)
   EXPECT_EQ(50, e5.time());
   EXPECT_EQ(5, e5.type());
 }
+
+TEST(testEventQueue, backend)
+{
+  ASSERT_NO_THROW(EventQueue{QueueBackendType::BinaryHeap});
+  ASSERT_NO_THROW(EventQueue{QueueBackendType::CalendarQueue});
+  ASSERT_NO_THROW(EventQueue{QueueBackendType::RadixHeap});
+  ASSERT_NO_THROW(EventQueue{QueueBackendType::TimingWheel});
+  ASSERT_NO_THROW(EventQueue{QueueBackendType::LadderQueue});
+  ASSERT_NO_THROW(EventQueue{QueueBackendType::QuaternaryHeap});
+  ASSERT_NO_THROW(EventQueue{QueueBackendType::OctonaryHeap});
+  ASSERT_NO_THROW(EventQueue{QueueBackendType::SortedArray});
+  ASSERT_NO_THROW(EventQueue{QueueBackendType::Adaptive});
+  ASSERT_THROW(EventQueue{std::unique_ptr<QueueBackend>{}}, std::invalid_argument);
+  ASSERT_THROW(EventQueue{(QueueBackendType)-1}, std::invalid_argument);
+
+  for(auto backendType : {QueueBackendType::BinaryHeap, QueueBackendType::CalendarQueue, QueueBackendType::RadixHeap,
+    QueueBackendType::TimingWheel, QueueBackendType::LadderQueue, QueueBackendType::QuaternaryHeap,
+    QueueBackendType::OctonaryHeap, QueueBackendType::SortedArray, QueueBackendType::Adaptive,
+    QueueBackendType::Partitioned})
+  {
+    EventQueue q{backendType};
+
+    // Insert events in an unordered fashion
+    q.insert(Event{30, 3});
+    q.insert(Event{10, 1});
+    q.insert(Event{50, 5});
+    q.insert(20, 2);
+    q.insert(Event{40, 4});
+    EXPECT_EQ(5, q.size());
+
+    // Events should be returned in ascending time order
+    for(SimTime t = 10; t <= 50; t += 10)
+    {
+      EXPECT_EQ(t, q.peekNext().time());
+
+      Event e = q.getNext();
+      EXPECT_EQ(t, e.time());
+      EXPECT_EQ(t / 10, e.type());
+    }
+
+    EXPECT_TRUE(q.empty());
+    ASSERT_THROW(q.peekNext(), std::runtime_error);
+    ASSERT_THROW(q.getNext(), std::runtime_error);
+  }
+}
+
+TEST(testEventQueue, bulk)
+{
+  for(auto backendType : {QueueBackendType::BinaryHeap, QueueBackendType::CalendarQueue, QueueBackendType::RadixHeap,
+    QueueBackendType::TimingWheel, QueueBackendType::LadderQueue, QueueBackendType::QuaternaryHeap,
+    QueueBackendType::OctonaryHeap, QueueBackendType::SortedArray, QueueBackendType::Adaptive,
+    QueueBackendType::Partitioned})
+  {
+    EventQueue q{backendType};
+    q.reserve(1100);
+    q.insert(Event{500, 0});
+
+    // Large range rebuilds the queue, small range is ordered individually
+    std::vector<Event> events;
+    for(SimTime i = 0; i < 1000; ++i)
+    {
+      events.push_back(Event{(i * 7919) % 1000, 1});
+    }
+    q.insertRange(events.begin(), events.end());
+    ASSERT_EQ(1001, q.size());
+
+    const Event few[] = {Event{1500, 2}, Event{250, 2}, Event{999, 2}};
+    q.insertRange(std::begin(few), std::end(few));
+    ASSERT_EQ(1004, q.size());
+
+    // Empty range has no effect
+    q.insertRange(events.end(), events.end());
+    ASSERT_EQ(1004, q.size());
+
+    SimTime last = 0;
+    while(!q.empty())
+    {
+      Event e = q.getNext();
+      ASSERT_LE(last, e.time());
+      last = e.time();
+    }
+    EXPECT_EQ(1500, last);
+  }
+
+  // Handles remain valid for events inserted after a bulk insertion
+  EventQueue q{};
+  std::vector<Event> events{Event{3, 0}, Event{1, 0}, Event{2, 0}};
+  EventHandle h = q.insertWithHandle(Event{4, 0});
+  q.insertRange(events.begin(), events.end());
+  EXPECT_TRUE(h.reschedule(0));
+  EXPECT_EQ(0, q.getNext().time());
+  EXPECT_FALSE(h.pending());
+  EXPECT_EQ(1, q.getNext().time());
+}
+
+TEST(testEventQueue, simultaneous)
+{
+  for(auto backendType : {QueueBackendType::BinaryHeap, QueueBackendType::CalendarQueue, QueueBackendType::RadixHeap,
+    QueueBackendType::TimingWheel, QueueBackendType::LadderQueue, QueueBackendType::QuaternaryHeap,
+    QueueBackendType::OctonaryHeap, QueueBackendType::SortedArray, QueueBackendType::Adaptive,
+    QueueBackendType::Partitioned})
+  {
+    EventQueue q{backendType};
+
+    // Events with equal times are returned in insertion order
+    for(EventType type = 0; type < 300; ++type)
+    {
+      q.insert(Event{(SimTime)(type % 3) * 1000, type});
+    }
+
+    for(SimTime t = 0; t < 3; ++t)
+    {
+      for(EventType type = t; type < 300; type += 3)
+      {
+        Event e = q.getNext();
+        EXPECT_EQ(t * 1000, e.time());
+        EXPECT_EQ(type, e.type());
+
+        // Events inserted at the current time order after those already queued
+        if(type == 150 + t)
+        {
+          q.insert(Event{t * 1000, 1000 + type});
+        }
+      }
+
+      Event e = q.getNext();
+      EXPECT_EQ(t * 1000, e.time());
+      EXPECT_EQ(1150 + t, e.type());
+    }
+
+    EXPECT_TRUE(q.empty());
+  }
+
+  // Rescheduled events order after events already queued for the new time
+  EventQueue q{};
+  q.insert(Event{5, 1});
+  EventHandle h = q.insertWithHandle(Event{1, 2});
+  q.insert(Event{5, 3});
+  EXPECT_TRUE(h.reschedule(5));
+  EXPECT_EQ(1, q.getNext().type());
+  EXPECT_EQ(3, q.getNext().type());
+  EXPECT_EQ(2, q.getNext().type());
+}
+
+TEST(testEventQueue, priority)
+{
+  for(auto backendType : {QueueBackendType::BinaryHeap, QueueBackendType::CalendarQueue, QueueBackendType::RadixHeap,
+    QueueBackendType::TimingWheel, QueueBackendType::LadderQueue, QueueBackendType::QuaternaryHeap,
+    QueueBackendType::OctonaryHeap, QueueBackendType::SortedArray, QueueBackendType::Adaptive,
+    QueueBackendType::Partitioned})
+  {
+    EventQueue q{backendType};
+
+    // Events with equal times are ordered by descending priority, then insertion order
+    q.insert(Event{10, 1, 0, 0});
+    q.insert(Event{10, 2, 0, 5});
+    q.insert(10, 3, 0, 1);
+    q.insert(Event{10, 4, 0, 5});
+    q.insert(Event{5, 5, 0, 0});
+    q.insert(Event{20, 6, 0, 65535});
+    q.insert(Event{10, 7, 0, 65535});
+
+    for(EventType type : {5, 7, 2, 4, 3, 1, 6})
+    {
+      Event e = q.getNext();
+      EXPECT_EQ(type, e.type());
+    }
+
+    EXPECT_TRUE(q.empty());
+  }
+
+  // Rescheduled events keep their priority
+  EventQueue q{};
+  EventHandle h = q.insertWithHandle(1, 1, 0, 2);
+  q.insert(Event{5, 2, 0, 1});
+  EXPECT_TRUE(h.reschedule(5));
+  EXPECT_EQ(1, q.peekNext().type());
+  EXPECT_EQ(2, q.getNext().priority());
+  EXPECT_EQ(2, q.getNext().type());
+}
+
+TEST(testEventQueue, sequence)
+{
+  // Insertion sequences are handed out up to the last one that fits in the order word
+  const uint64_t last = ((uint64_t)1 << EventKey::SequenceBits) - 1;
+  uint64_t next = last - 1;
+  EXPECT_EQ(last - 1, EventKey::Next(next));
+  EXPECT_EQ(last, EventKey::Next(next));
+  EXPECT_LT(EventKey::Order(0, last - 1), EventKey::Order(0, last));
+
+  // Then the queue refuses to wrap around
+  EXPECT_THROW(EventKey::Next(next), std::overflow_error);
+  EXPECT_EQ(last + 1, next);
+  EXPECT_THROW(EventKey::Checked(last + 1), std::overflow_error);
+}
+
+TEST(testEventQueue, lanes)
+{
+  for(auto backendType : {QueueBackendType::BinaryHeap, QueueBackendType::CalendarQueue, QueueBackendType::RadixHeap,
+    QueueBackendType::TimingWheel, QueueBackendType::LadderQueue, QueueBackendType::QuaternaryHeap,
+    QueueBackendType::OctonaryHeap, QueueBackendType::SortedArray, QueueBackendType::Adaptive,
+    QueueBackendType::Partitioned})
+  {
+    EventQueue q{backendType};
+    q.addLane(1, 10);
+    q.addLane(2, 5);
+    EXPECT_EQ(2, q.laneCount());
+    EXPECT_TRUE(q.hasLane(1));
+    EXPECT_FALSE(q.hasLane(3));
+    EXPECT_EQ(10, q.laneDelay(1));
+    EXPECT_EQ(5, q.laneDelay(2));
+    EXPECT_THROW(q.laneDelay(3), std::invalid_argument);
+    EXPECT_THROW(q.addLane(1, 1), std::invalid_argument);
+
+    // Lane events are merged with other events in time, priority and insertion order
+    q.insert(Event{10, 1, 0});
+    q.insert(Event{10, 3, 1});
+    q.insert(Event{5, 2, 2});
+    q.insert(Event{10, 2, 3});
+    q.insert(Event{20, 1, 4});
+    q.insert(Event{10, 3, 5, 1});
+
+    // Out of order for its lane
+    q.insert(Event{15, 1, 6});
+    q.insert(Event{10, 1, 7});
+    EXPECT_EQ(8, q.size());
+
+    for(EventTag tag : {2, 5, 0, 1, 3, 7, 6, 4})
+    {
+      ASSERT_FALSE(q.empty());
+      EXPECT_EQ(tag, q.peekNext().tag());
+      EXPECT_EQ(tag, q.getNext().tag());
+    }
+
+    EXPECT_TRUE(q.empty());
+    EXPECT_THROW(q.getNext(), std::runtime_error);
+  }
+}
+
+TEST(testEventQueue, indices)
+{
+  for(auto backendType : {QueueBackendType::BinaryHeap, QueueBackendType::CalendarQueue, QueueBackendType::RadixHeap,
+    QueueBackendType::TimingWheel, QueueBackendType::LadderQueue, QueueBackendType::QuaternaryHeap,
+    QueueBackendType::OctonaryHeap, QueueBackendType::SortedArray, QueueBackendType::Adaptive,
+    QueueBackendType::Partitioned})
+  {
+    EventQueue q{backendType};
+    EXPECT_FALSE(q.indexed());
+    EXPECT_THROW(q.count(1), std::logic_error);
+    EXPECT_THROW(q.findNext(1), std::logic_error);
+
+    q.addLane(3, 10);
+    q.enableIndices();
+    EXPECT_TRUE(q.indexed());
+    EXPECT_EQ(nullptr, q.findNext(100));
+
+    q.insert(Event{10, 1, 100});
+    q.insert(Event{5, 2, 100});
+    q.insert(Event{7, 1, 200});
+    q.insert(Event{10, 3, 200});
+    std::vector<Event> events{Event{3, 1, 300}, Event{6, 2, 100}};
+    q.insertRange(events.begin(), events.end());
+
+    EXPECT_EQ(3, q.count(1));
+    EXPECT_EQ(2, q.count(2));
+    EXPECT_EQ(1, q.count(3));
+    EXPECT_EQ(0, q.count(4));
+    ASSERT_NE(nullptr, q.findNext(100));
+    EXPECT_EQ(5, q.findNext(100)->time());
+    EXPECT_EQ(7, q.findNext(200)->time());
+    EXPECT_EQ(nullptr, q.findNext(400));
+
+    // Indices follow removals
+    EXPECT_EQ(3, q.getNext().time());
+    EXPECT_EQ(5, q.getNext().time());
+    EXPECT_EQ(2, q.count(1));
+    EXPECT_EQ(1, q.count(2));
+    EXPECT_EQ(6, q.findNext(100)->time());
+    EXPECT_EQ(nullptr, q.findNext(300));
+
+    while(!q.empty())
+    {
+      q.getNext();
+    }
+
+    EXPECT_EQ(0, q.count(1));
+    EXPECT_EQ(nullptr, q.findNext(200));
+  }
+
+  // Indices follow cancelled and rescheduled events
+  EventQueue q{};
+  q.enableIndices();
+  EventHandle h1 = q.insertWithHandle(10, 1, 100);
+  EventHandle h2 = q.insertWithHandle(20, 1, 100);
+  EXPECT_EQ(2, q.count(1));
+  EXPECT_EQ(10, q.findNext(100)->time());
+
+  EXPECT_TRUE(h2.reschedule(5));
+  EXPECT_EQ(5, q.findNext(100)->time());
+  EXPECT_TRUE(h2.cancel());
+  EXPECT_FALSE(h2.cancel());
+  EXPECT_EQ(1, q.count(1));
+  EXPECT_EQ(10, q.findNext(100)->time());
+  EXPECT_EQ(10, q.getNext().time());
+  EXPECT_FALSE(h1.reschedule(30));
+  EXPECT_EQ(0, q.count(1));
+
+  // A tag whose only event was cancelled is absent, other tags are unaffected
+  EventHandle h3 = q.insertWithHandle(40, 2, 300);
+  q.insert(50, 2, 400);
+  const Event* next = q.findNext(300);
+  ASSERT_NE(nullptr, next);
+  EXPECT_EQ(40, next->time());
+  EXPECT_TRUE(h3.cancel());
+  EXPECT_EQ(nullptr, q.findNext(300));
+  EXPECT_EQ(50, q.findNext(400)->time());
+
+  // Indices must be enabled before events are inserted
+  EventQueue q2{};
+  q2.insert(1, 1);
+  EXPECT_THROW(q2.enableIndices(), std::runtime_error);
+}
+
+TEST_P(testQueueBackend, order)
+{
+  std::unique_ptr<QueueBackend> q = createBackend();
+  std::default_random_engine rng{1234};
+  std::uniform_int_distribution<SimTime> dist{0, UINT64_MAX};
+
+  // Insert events in random order, including small times, repeated times and times with the top bit set
+  std::vector<std::pair<SimTime, EventTag>> expected{};
+  for(EventTag i = 0; i < 1000; ++i)
+  {
+    SimTime t = (i % 10 == 0) ? (SimTime)(i % 7) : (i % 3 == 0) ? dist(rng) % 100000 : dist(rng);
+    expected.push_back(std::make_pair(t, i));
+    q->insert(Event{t, 0, i});
+    ASSERT_EQ(expected.size(), q->size());
+  }
+
+  // Events should be returned in ascending time order, equal times in insertion order
+  std::sort(expected.begin(), expected.end());
+  for(const auto& e : expected)
+  {
+    ASSERT_EQ(e.first, q->peekNext().time());
+    Event evt = q->getNext();
+    ASSERT_EQ(e.first, evt.time());
+    ASSERT_EQ(e.second, evt.tag());
+  }
+
+  EXPECT_EQ(0, q->size());
+}
+
+TEST_P(testQueueBackend, hold)
+{
+  std::unique_ptr<QueueBackend> q = createBackend();
+  std::default_random_engine rng{5678};
+  std::uniform_int_distribution<SimTime> dist{0, 100};
+
+  for(int i = 0; i < 100; ++i)
+  {
+    q->insert(Event{dist(rng), 0});
+  }
+
+  // Repeatedly remove the next event and schedule another at or after it
+  SimTime now = 0;
+  for(int i = 0; i < 10000; ++i)
+  {
+    Event e = q->getNext();
+    ASSERT_LE(now, e.time());
+    now = e.time();
+
+    q->insert(Event{now + dist(rng), 0});
+    ASSERT_EQ(100, q->size());
+  }
+
+  // Drain and refill
+  while(q->size() > 0)
+  {
+    q->getNext();
+  }
+
+  q->insert(Event{now + 7, 7});
+  EXPECT_EQ(7, q->peekNext().type());
+  EXPECT_EQ(now + 7, q->getNext().time());
+}
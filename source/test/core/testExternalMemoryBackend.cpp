@@ -0,0 +1,187 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/EventQueue.h"
+#include "core/ExternalMemoryBackend.h"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace des;
+
+namespace _testExternalMemoryBackend
+{
+  const std::string Prefix = "testExternalMemoryBackend_";
+
+  // Memory budget holding the given number of events
+  inline size_t Budget(const size_t events)
+  { return events * sizeof(KeyedEvent); }
+
+  // True if the run file with the given index exists
+  inline bool RunExists(const size_t index)
+  { return std::ifstream{Prefix + std::to_string(index) + ".run"}.good(); }
+}
+using namespace _testExternalMemoryBackend;
+
+TEST(testExternalMemoryBackend, ctor)
+{
+  ExternalMemoryBackend q{Prefix, Budget(100)};
+  EXPECT_EQ(100, q.memoryLimit());
+  EXPECT_EQ(0, q.size());
+  EXPECT_EQ(0, q.runCount());
+
+  EXPECT_THROW(ExternalMemoryBackend(Prefix, Budget(1)), std::invalid_argument);
+}
+
+TEST(testExternalMemoryBackend, order)
+{
+  std::default_random_engine rng{1234};
+  std::uniform_int_distribution<SimTime> timeDist{0, 1000};
+  std::uniform_int_distribution<EventPriority> priorityDist{0, 3};
+
+  ExternalMemoryBackend q{Prefix, Budget(64)};
+
+  // Insert far more events than fit in memory
+  std::vector<std::tuple<SimTime, EventPriority, EventTag>> expected{};
+  for(EventTag i = 0; i < 2000; ++i)
+  {
+    SimTime t = timeDist(rng);
+    EventPriority p = priorityDist(rng);
+    expected.push_back(std::make_tuple(t, (EventPriority)(3 - p), i));
+    q.insert(Event{t, 1, i, p, i % 7});
+    ASSERT_LE(q.memoryCount(), q.memoryLimit());
+  }
+
+  EXPECT_EQ(2000, q.size());
+  EXPECT_LT(0, q.runCount());
+
+  // Events should come back in time, priority and insertion order, with priorities and targets restored from disk
+  std::sort(expected.begin(), expected.end());
+  for(const auto& e : expected)
+  {
+    ASSERT_EQ(std::get<0>(e), q.peekNext().time());
+    Event evt = q.getNext();
+    ASSERT_EQ(std::get<0>(e), evt.time());
+    ASSERT_EQ(3 - std::get<1>(e), evt.priority());
+    ASSERT_EQ(std::get<2>(e), evt.tag());
+    ASSERT_EQ(std::get<2>(e) % 7, evt.target());
+    ASSERT_LE(q.memoryCount(), q.memoryLimit());
+  }
+
+  EXPECT_EQ(0, q.size());
+  EXPECT_EQ(0, q.runCount());
+}
+
+TEST(testExternalMemoryBackend, hold)
+{
+  std::default_random_engine rng{4321};
+  std::uniform_int_distribution<SimTime> delayDist{1, 500};
+
+  EventQueue q{std::unique_ptr<QueueBackend>{new ExternalMemoryBackend{Prefix, Budget(32)}}};
+  for(EventTag i = 0; i < 300; ++i)
+  {
+    q.insert(delayDist(rng), 1, i);
+  }
+
+  // Events scheduled ahead of the current time as the simulation advances
+  SimTime last = 0;
+  for(int i = 0; i < 5000; ++i)
+  {
+    Event e = q.getNext();
+    ASSERT_LE(last, e.time());
+    last = e.time();
+    q.insert(e.time() + delayDist(rng), 1, e.tag());
+  }
+
+  EXPECT_EQ(300, q.size());
+}
+
+TEST(testExternalMemoryBackend, cleanup)
+{
+  {
+    ExternalMemoryBackend q{Prefix, Budget(8)};
+    for(EventTag i = 0; i < 100; ++i)
+    {
+      q.insert(Event{100 - i, 1, i});
+    }
+
+    ASSERT_LT(0, q.runCount());
+    EXPECT_TRUE(RunExists(0));
+  }
+
+  // Run files are removed with the backend
+  for(size_t i = 0; i < 100; ++i)
+  {
+    EXPECT_FALSE(RunExists(i));
+  }
+}
+
+TEST(testExternalMemoryBackend, merge)
+{
+  std::default_random_engine rng{5678};
+  std::uniform_int_distribution<SimTime> timeDist{0, 100000};
+
+  ExternalMemoryBackend q{Prefix, Budget(16)};
+
+  // Many small runs are merged rather than each keeping a file open
+  std::vector<std::pair<SimTime, EventTag>> expected{};
+  size_t maxRuns = 0;
+  for(EventTag i = 0; i < 20000; ++i)
+  {
+    SimTime t = timeDist(rng);
+    expected.push_back(std::make_pair(t, i));
+    q.insert(Event{t, 1, i});
+    maxRuns = std::max(maxRuns, q.runCount());
+
+    // Remove a few events along the way so runs are merged part way through reading
+    if(i % 1000 == 999)
+    {
+      std::sort(expected.begin(), expected.end());
+      for(int j = 0; j < 10; ++j)
+      {
+        Event evt = q.getNext();
+        ASSERT_EQ(expected.front().first, evt.time());
+        ASSERT_EQ(expected.front().second, evt.tag());
+        expected.erase(expected.begin());
+      }
+    }
+  }
+
+  EXPECT_EQ(ExternalMemoryBackend::MaxRuns, maxRuns);
+
+  std::sort(expected.begin(), expected.end());
+  for(const auto& e : expected)
+  {
+    Event evt = q.getNext();
+    ASSERT_EQ(e.first, evt.time());
+    ASSERT_EQ(e.second, evt.tag());
+  }
+
+  EXPECT_EQ(0, q.size());
+  EXPECT_EQ(0, q.runCount());
+}
+
+TEST(testExternalMemoryBackend, spillFailure)
+{
+  ExternalMemoryBackend q{"missing_directory/" + Prefix, Budget(4)};
+  for(EventTag i = 0; i < 4; ++i)
+  {
+    q.insert(Event{10 - i, 1, i});
+  }
+
+  // Failing to spill keeps the events in memory
+  EXPECT_THROW(q.insert(Event{5, 1, 4}), std::runtime_error);
+  EXPECT_EQ(5, q.size());
+  EXPECT_EQ(0, q.runCount());
+
+  for(SimTime t : {5, 7, 8, 9, 10})
+  {
+    EXPECT_EQ(t, q.getNext().time());
+  }
+  EXPECT_EQ(0, q.size());
+}
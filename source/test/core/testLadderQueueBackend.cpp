@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/LadderQueueBackend.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace des;
+
+TEST(testLadderQueueBackend, ctor)
+{
+  LadderQueueBackend q{};
+
+  EXPECT_EQ(0, q.size());
+  EXPECT_EQ(0, q.rungCount());
+}
+
+TEST(testLadderQueueBackend, burst)
+{
+  LadderQueueBackend q{};
+  std::default_random_engine rng{9012};
+  std::uniform_int_distribution<SimTime> spread{0, 1000000};
+  std::uniform_int_distribution<SimTime> burst{500000, 500100};
+
+  // Mostly burst arrivals within a narrow window, plus a few spread out
+  std::vector<SimTime> times{};
+  for(int i = 0; i < 5000; ++i)
+  {
+    SimTime t = (i % 50 == 0) ? spread(rng) : burst(rng);
+    times.push_back(t);
+    q.insert(Event{t, 0});
+  }
+
+  std::sort(times.begin(), times.end());
+  size_t maxRungs = 0;
+  for(auto t : times)
+  {
+    ASSERT_EQ(t, q.getNext().time());
+    maxRungs = std::max(maxRungs, q.rungCount());
+  }
+
+  // Burst bucket should have spawned additional rungs
+  EXPECT_GT(maxRungs, 1);
+  EXPECT_LE(maxRungs, LadderQueueBackend::MaxRungs);
+}
+
+TEST(testLadderQueueBackend, interleaved)
+{
+  LadderQueueBackend q{};
+
+  for(SimTime t = 100; t < 200; ++t)
+  {
+    q.insert(Event{t, 0});
+  }
+
+  EXPECT_EQ(100, q.getNext().time());
+
+  // Insert into Bottom, the ladder and Top
+  q.insert(Event{101, 1});
+  q.insert(Event{150, 2});
+  q.insert(Event{1000, 3});
+  q.insert(Event{UINT64_MAX, 4});
+
+  EXPECT_EQ(101, q.getNext().time());
+  EXPECT_EQ(101, q.getNext().time());
+
+  SimTime last = 101;
+  while(q.size() > 0)
+  {
+    Event e = q.getNext();
+    ASSERT_LE(last, e.time());
+    last = e.time();
+  }
+
+  EXPECT_EQ(UINT64_MAX, last);
+}
+
+TEST(testLadderQueueBackend, outlier)
+{
+  LadderQueueBackend q{};
+  std::default_random_engine rng{3456};
+  std::uniform_int_distribution<SimTime> dist{1, 1000};
+
+  // One far-future event spreads the first rung over a wide span
+  q.insert(Event{0, 0});
+  q.insert(Event{1000000000, 1});
+  EXPECT_EQ(0, q.getNext().time());
+
+  // Nearer events precede the first rung's next bucket and must not pile up in Bottom
+  SimTime now = 0;
+  for(int i = 0; i < 100000; ++i)
+  {
+    q.insert(Event{now + dist(rng), 0});
+  }
+
+  for(int i = 0; i < 100000; ++i)
+  {
+    Event e = q.getNext();
+    ASSERT_LE(now, e.time());
+    now = e.time();
+
+    q.insert(Event{now + dist(rng), 0});
+  }
+
+  EXPECT_LE(q.rungCount(), LadderQueueBackend::MaxRungs);
+  while(q.size() > 1)
+  {
+    Event e = q.getNext();
+    ASSERT_LE(now, e.time());
+    now = e.time();
+  }
+
+  EXPECT_EQ(1, q.getNext().type());
+}
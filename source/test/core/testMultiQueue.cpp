@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/MultiQueue.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace des;
+
+TEST(testMultiQueue, ctor)
+{
+  MultiQueue q{};
+  EXPECT_LE(2, q.queueCount());
+  EXPECT_TRUE(q.empty());
+
+  Event e{0, 0};
+  EXPECT_FALSE(q.tryGetNext(e));
+
+  EXPECT_THROW(MultiQueue{0}, std::invalid_argument);
+}
+
+TEST(testMultiQueue, exact)
+{
+  // A single heap returns events in time, priority and insertion order
+  MultiQueue q{1};
+  q.insert(10, 1);
+  q.insert(5, 2);
+  q.insert(10, 3, 0, 1);
+  q.insert(Event{10, 4});
+  ASSERT_EQ(4, q.size());
+
+  Event e{0, 0};
+  for(EventType type : {2, 3, 1, 4})
+  {
+    ASSERT_TRUE(q.tryGetNext(e));
+    EXPECT_EQ(type, e.type());
+  }
+
+  EXPECT_FALSE(q.tryGetNext(e));
+}
+
+TEST(testMultiQueue, rankError)
+{
+  const size_t queueCount = 8;
+  const SimTime count = 4000;
+
+  std::vector<SimTime> times(count);
+  std::iota(times.begin(), times.end(), 0);
+  std::shuffle(times.begin(), times.end(), std::default_random_engine{1234});
+
+  MultiQueue q{queueCount};
+  for(SimTime t : times)
+  {
+    q.insert(t, 0);
+  }
+
+  // Rank error is the number of held events earlier than the removed one
+  std::vector<bool> removed(count, false);
+  size_t totalError = 0;
+  size_t maxError = 0;
+  Event e{0, 0};
+  while(q.tryGetNext(e))
+  {
+    ASSERT_FALSE(removed[e.time()]);
+    removed[e.time()] = true;
+
+    const size_t error = std::count(removed.begin(), removed.begin() + e.time(), false);
+    totalError += error;
+    maxError = std::max(maxError, error);
+  }
+
+  EXPECT_TRUE(std::all_of(removed.begin(), removed.end(), [] (bool b) { return b; }));
+  EXPECT_GT(4 * queueCount, totalError / count);
+  EXPECT_GT(50 * queueCount, maxError);
+}
+
+TEST(testMultiQueue, threads)
+{
+  const size_t threadCount = 4;
+  const EventTag perThread = 10000;
+
+  MultiQueue q{2 * threadCount};
+
+  // Insert from several threads at once
+  std::vector<std::thread> threads{};
+  for(size_t i = 0; i < threadCount; ++i)
+  {
+    threads.emplace_back([&q, i, perThread] ()
+    {
+      std::default_random_engine rng{(unsigned)i};
+      std::uniform_int_distribution<SimTime> dist{0, 1000};
+      for(EventTag n = 0; n < perThread; ++n)
+      {
+        q.insert(dist(rng), (EventType)i, n);
+      }
+    });
+  }
+
+  for(auto& t : threads)
+  {
+    t.join();
+  }
+
+  ASSERT_EQ(threadCount * perThread, q.size());
+
+  // Remove from several threads at once, each thread reinserting some events
+  std::vector<std::vector<EventTag>> seen(threadCount, std::vector<EventTag>(threadCount * perThread, 0));
+  threads.clear();
+  for(size_t i = 0; i < threadCount; ++i)
+  {
+    threads.emplace_back([&q, &seen, i, perThread] ()
+    {
+      Event e{0, 0};
+      size_t reinserted = 0;
+      while(q.tryGetNext(e))
+      {
+        if((reinserted < 100) && (e.tag() % 2 == 0) && (e.time() < 1000))
+        {
+          q.insert(e.time() + 1000, e.type(), e.tag());
+          ++reinserted;
+          continue;
+        }
+
+        ++seen[i][(e.type() * perThread) + e.tag()];
+      }
+    });
+  }
+
+  for(auto& t : threads)
+  {
+    t.join();
+  }
+
+  // Every event is removed exactly once
+  EXPECT_TRUE(q.empty());
+  for(size_t n = 0; n < threadCount * perThread; ++n)
+  {
+    EventTag total = 0;
+    for(size_t i = 0; i < threadCount; ++i)
+    {
+      total += seen[i][n];
+    }
+
+    ASSERT_EQ(1, total);
+  }
+}
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/PartitionedBackend.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace des;
+
+TEST(testPartitionedBackend, ctor)
+{
+  PartitionedBackend q{};
+  EXPECT_EQ(PartitionedBackend::DefaultPartitions, q.partitionCount());
+  EXPECT_EQ(0, q.size());
+
+  PartitionedBackend q3{3};
+  EXPECT_EQ(3, q3.partitionCount());
+  EXPECT_EQ(0, q3.partition(3));
+  EXPECT_EQ(2, q3.partition(5));
+
+  EXPECT_THROW(PartitionedBackend{0}, std::invalid_argument);
+}
+
+TEST(testPartitionedBackend, order)
+{
+  for(size_t partitionCount : {1, 3, 16})
+  {
+    PartitionedBackend q{partitionCount};
+    std::default_random_engine rng{1234};
+    std::uniform_int_distribution<SimTime> timeDist{0, 100};
+    std::uniform_int_distribution<EventType> typeDist{0, 20};
+
+    // Insert events of random types in random order
+    std::vector<std::pair<SimTime, EventTag>> expected{};
+    for(EventTag i = 0; i < 500; ++i)
+    {
+      SimTime t = timeDist(rng);
+      expected.push_back(std::make_pair(t, i));
+      q.insert(Event{t, typeDist(rng), i});
+    }
+
+    // Events should be returned in ascending time order, equal times in insertion order
+    std::sort(expected.begin(), expected.end());
+    for(const auto& e : expected)
+    {
+      ASSERT_EQ(e.first, q.peekNext().time());
+      Event evt = q.getNext();
+      ASSERT_EQ(e.first, evt.time());
+      ASSERT_EQ(e.second, evt.tag());
+    }
+
+    EXPECT_EQ(0, q.size());
+  }
+}
+
+TEST(testPartitionedBackend, interleaved)
+{
+  PartitionedBackend q{4};
+
+  // Each handler reschedules its own event type, as in a running simulation
+  for(EventType type = 0; type < 8; ++type)
+  {
+    q.insert(Event{type, type});
+  }
+
+  SimTime last = 0;
+  for(int i = 0; i < 1000; ++i)
+  {
+    Event e = q.getNext();
+    ASSERT_LE(last, e.time());
+    last = e.time();
+    q.insert(Event{e.time() + e.type() + 1, e.type()});
+  }
+
+  EXPECT_EQ(8, q.size());
+}
@@ -0,0 +1,48 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/RadixHeapBackend.h"
+
+using namespace des;
+
+TEST(testRadixHeapBackend, ctor)
+{
+  RadixHeapBackend q{};
+
+  EXPECT_EQ(0, q.size());
+}
+
+TEST(testRadixHeapBackend, extremes)
+{
+  RadixHeapBackend q{};
+
+  q.insert(Event{UINT64_MAX, 1});
+  q.insert(Event{0, 2});
+  q.insert(Event{UINT64_MAX - 1, 3});
+
+  EXPECT_EQ(2, q.getNext().type());
+  EXPECT_EQ(3, q.getNext().type());
+  EXPECT_EQ(1, q.getNext().type());
+  EXPECT_EQ(0, q.size());
+}
+
+TEST(testRadixHeapBackend, early)
+{
+  RadixHeapBackend q{};
+
+  q.insert(Event{10, 1});
+  q.insert(Event{20, 2});
+  EXPECT_EQ(10, q.getNext().time());
+
+  // Peeking re-keys the buckets from the next event
+  EXPECT_EQ(20, q.peekNext().time());
+
+  // Events before the last removed time are returned first
+  q.insert(Event{15, 3});
+  q.insert(Event{5, 4});
+  EXPECT_EQ(3, q.size());
+
+  EXPECT_EQ(5, q.getNext().time());
+  EXPECT_EQ(15, q.getNext().time());
+  EXPECT_EQ(20, q.getNext().time());
+  EXPECT_EQ(0, q.size());
+}
@@ -3,6 +3,10 @@
 #include "core/Event.h"
 #include "core/EventHandler.h"
 #include "core/SimEngine.h"
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <vector>
 
 using namespace des;
 using ::testing::Ref;
@@ -23,6 +27,74 @@ namespace _testSimEngine
     MOCK_METHOD1(finalize, void(SimEngine& sim));
   };
 
+  // Records the batches passed to handleEvents as (time, type, size)
+  class BatchHandler : public EventHandler
+  {
+  public:
+    void handleEvent(SimEngine& sim, const Event& evt) override
+    { ADD_FAILURE() << "Batch handler called with a single event"; }
+
+    void handleEvents(SimEngine& sim, EventSpan events) override
+    {
+      batches.push_back(std::make_tuple(events[0].time(), events[0].type(), events.size()));
+      for(const auto& evt : events)
+      {
+        tags.push_back(evt.tag());
+      }
+    }
+
+    void initialize(SimEngine& sim) override
+    {}
+
+    void finalize(SimEngine& sim) override
+    {}
+
+    std::vector<std::tuple<SimTime, EventType, size_t>> batches;
+    std::vector<EventTag> tags;
+  };
+
+  // Calls a function with each event it handles
+  class CallbackHandler : public EventHandler
+  {
+  public:
+    explicit CallbackHandler(std::function<void(SimEngine&, const Event&)> callback) :
+      callback{callback}
+    {}
+
+    void handleEvent(SimEngine& sim, const Event& evt) override
+    { callback(sim, evt); }
+
+    void initialize(SimEngine& sim) override
+    {}
+
+    void finalize(SimEngine& sim) override
+    {}
+
+    std::function<void(SimEngine&, const Event&)> callback;
+  };
+
+  // Counts the events it handles and the calls to initialize and finalize
+  class LifecycleHandler : public EventHandler
+  {
+  public:
+    LifecycleHandler() :
+      events{0}, initialized{0}, finalized{0}
+    {}
+
+    void handleEvent(SimEngine& sim, const Event& evt) override
+    { ++events; }
+
+    void initialize(SimEngine& sim) override
+    { ++initialized; }
+
+    void finalize(SimEngine& sim) override
+    { ++finalized; }
+
+    int events;
+    int initialized;
+    int finalized;
+  };
+
   MATCHER_P(EventEQ, evt, "Event matcher")
   { return ((evt.time() == arg.time()) && (evt.type() == arg.type()) && (evt.tag() == arg.tag())); }
 }
@@ -514,3 +586,834 @@ TEST(testSimEngine, step_3_handlers)
   ASSERT_NO_THROW(sim.finalize());
   ASSERT_EQ(SimEngineState::Finalized, sim.state());
 }
+
+TEST(testSimEngine, backend)
+{
+  ASSERT_THROW(SimEngine{std::unique_ptr<QueueBackend>{}}, std::invalid_argument);
+
+  for(auto backendType : {QueueBackendType::BinaryHeap, QueueBackendType::CalendarQueue, QueueBackendType::RadixHeap,
+    QueueBackendType::TimingWheel, QueueBackendType::LadderQueue, QueueBackendType::QuaternaryHeap,
+    QueueBackendType::OctonaryHeap, QueueBackendType::SortedArray, QueueBackendType::Adaptive,
+    QueueBackendType::Partitioned})
+  {
+    SimEngine sim{backendType};
+
+    sim.insertEvent(3, 30);
+    sim.insertEvent(1, 10);
+    sim.insertEvent(2, 20);
+    sim.initialize();
+
+    EXPECT_EQ(1, sim.step().time());
+    EXPECT_EQ(2, sim.step().time());
+
+    // Causality violations are still detected
+    sim.insertEvent(1, 40);
+    ASSERT_THROW(sim.step(), CausalityException);
+    EXPECT_EQ(3, sim.step().time());
+    EXPECT_FALSE(sim.hasNextEvent());
+    ASSERT_EQ(SimEngineState::Running, sim.state());
+  }
+}
+
+TEST(testSimEngine, handles)
+{
+  Event e1{1, 10};
+  Event e2{2, 20};
+  Event e3{3, 30};
+
+  SimEngine sim{};
+  MockHandler h1{};
+  sim.subscribe(&h1);
+
+  sim.insertEvent(e1);
+  EventHandle timeout = sim.insertEventWithHandle(e2);
+  EventHandle delayed = sim.insertEventWithHandle(3, 30);
+  ASSERT_EQ(3, sim.eventCount());
+
+  EXPECT_CALL(h1, initialize(Ref(sim))).Times(1);
+  sim.initialize();
+
+  // Cancelled event is never dispatched, rescheduled event is dispatched at its new time
+  EXPECT_CALL(h1, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+  EXPECT_CALL(h1, handleEvent(Ref(sim), EventEQ(e2))).Times(0);
+  EXPECT_CALL(h1, handleEvent(Ref(sim), EventEQ(e3))).Times(0);
+  EXPECT_CALL(h1, handleEvent(Ref(sim), EventEQ(Event{5, 30}))).Times(1);
+
+  sim.step();
+  EXPECT_TRUE(timeout.cancel());
+  EXPECT_TRUE(delayed.reschedule(5));
+  ASSERT_EQ(1, sim.eventCount());
+
+  EXPECT_EQ(5, sim.step().time());
+  EXPECT_FALSE(sim.hasNextEvent());
+  EXPECT_FALSE(delayed.pending());
+
+  // Backends without handle support
+  SimEngine calendar{QueueBackendType::CalendarQueue};
+  ASSERT_THROW(calendar.insertEventWithHandle(e1), std::logic_error);
+}
+
+TEST(testSimEngine, reschedule_targeted)
+{
+  // Rescheduled events keep their target, with and without indices over the schedule
+  for(const bool indexed : {false, true})
+  {
+    SimEngine sim{};
+    MockHandler subscriber{};
+    MockHandler target{};
+    sim.subscribe(&subscriber, 10);
+
+    if(indexed)
+    {
+      sim.enableEventIndices();
+    }
+
+    EventHandle handle = sim.insertEventWithHandle(Event{1, 10, 0, 0, sim.registerTarget(&target)});
+
+    EXPECT_CALL(subscriber, initialize(Ref(sim))).Times(1);
+    EXPECT_CALL(target, initialize(Ref(sim))).Times(1);
+    sim.initialize();
+
+    EXPECT_TRUE(handle.reschedule(5));
+    EXPECT_CALL(subscriber, handleEvent(Ref(sim), ::testing::_)).Times(0);
+    EXPECT_CALL(target, handleEvent(Ref(sim), EventEQ(Event{5, 10}))).Times(1);
+    EXPECT_EQ(1, sim.run());
+
+    EXPECT_CALL(subscriber, finalize(Ref(sim))).Times(1);
+    EXPECT_CALL(target, finalize(Ref(sim))).Times(1);
+    sim.finalize();
+  }
+}
+
+TEST(testSimEngine, insertEvents)
+{
+  std::vector<Event> events{Event{3, 30}, Event{1, 10}, Event{2, 20}};
+
+  SimEngine sim{};
+  sim.reserveEvents(4);
+  sim.insertEvents(events.begin(), events.end());
+  sim.insertEvent(0, 40);
+  ASSERT_EQ(4, sim.eventCount());
+
+  sim.initialize();
+  EXPECT_EQ(0, sim.step().time());
+  EXPECT_EQ(1, sim.step().time());
+  EXPECT_EQ(2, sim.step().time());
+  EXPECT_EQ(3, sim.step().time());
+  EXPECT_FALSE(sim.hasNextEvent());
+}
+
+TEST(testSimEngine, lanes)
+{
+  SimEngine sim{};
+  sim.addEventLane(1, 1);
+  sim.addEventLane(2, 2);
+  EXPECT_THROW(sim.addEventLane(1, 3), std::invalid_argument);
+  EXPECT_THROW(sim.insertDelayedEvent(3), std::invalid_argument);
+
+  sim.initialize();
+  sim.insertDelayedEvent(2, 10);
+  sim.insertDelayedEvent(1, 20);
+  sim.insertEvent(1, 3, 30);
+
+  // Lane events are scheduled the lane delay after the current time
+  Event evt = sim.step();
+  EXPECT_EQ(1, evt.time());
+  EXPECT_EQ(20, evt.tag());
+  sim.insertDelayedEvent(1, 40);
+
+  evt = sim.step();
+  EXPECT_EQ(1, evt.time());
+  EXPECT_EQ(30, evt.tag());
+
+  evt = sim.step();
+  EXPECT_EQ(2, evt.time());
+  EXPECT_EQ(10, evt.tag());
+
+  evt = sim.step();
+  EXPECT_EQ(2, evt.time());
+  EXPECT_EQ(40, evt.tag());
+  EXPECT_FALSE(sim.hasNextEvent());
+}
+
+TEST(testSimEngine, indices)
+{
+  SimEngine sim{};
+  EXPECT_THROW(sim.eventCount(1), std::logic_error);
+
+  sim.enableEventIndices();
+  sim.insertEvent(2, 1, 10);
+  sim.insertEvent(1, 1, 20);
+  sim.insertEvent(3, 2, 10);
+  EXPECT_EQ(2, sim.eventCount(1));
+  EXPECT_EQ(1, sim.eventCount(2));
+  EXPECT_EQ(2, sim.findNextEvent(10)->time());
+
+  sim.initialize();
+  sim.step();
+  sim.step();
+  EXPECT_EQ(0, sim.eventCount(1));
+  EXPECT_EQ(3, sim.findNextEvent(10)->time());
+  EXPECT_EQ(nullptr, sim.findNextEvent(20));
+  EXPECT_THROW(sim.enableEventIndices(), std::runtime_error);
+}
+
+TEST(testSimEngine, dispatch_order)
+{
+  Event e1{1, 10};
+  Event e2{2, 20};
+
+  SimEngine sim{};
+  sim.insertEvent(e1);
+  sim.insertEvent(e2);
+
+  // Handlers on the stack in reverse of subscription order, so address order differs from it
+  MockHandler h4{};
+  MockHandler h3{};
+  MockHandler h2{};
+  MockHandler h1{};
+
+  sim.subscribe(&h1, 10);
+  sim.subscribe(&h2, 10);
+  sim.subscribe(&h3);
+  sim.subscribe(&h4, 10);
+  sim.subscribe(&h1, 20);
+  sim.subscribe(&h2, 20);
+  sim.subscribe(&h4, 20);
+
+  // Resubscribing keeps the original position
+  sim.subscribe(&h1, 10);
+
+  // Higher priority handlers go first, equal priorities in subscription order
+  sim.setHandlerPriority(&h4, 1);
+  sim.setHandlerPriority(&h2, 1);
+  sim.setHandlerPriority(&h1, 2);
+  sim.setHandlerPriority(&h1, 0);
+  EXPECT_EQ(1, sim.handlerPriority(&h4));
+  EXPECT_EQ(0, sim.handlerPriority(&h1));
+  EXPECT_THROW(sim.setHandlerPriority(nullptr, 1), std::invalid_argument);
+
+  {
+    ::testing::InSequence seq{};
+    EXPECT_CALL(h3, initialize(Ref(sim))).Times(1);
+    EXPECT_CALL(h2, initialize(Ref(sim))).Times(1);
+    EXPECT_CALL(h4, initialize(Ref(sim))).Times(1);
+    EXPECT_CALL(h1, initialize(Ref(sim))).Times(1);
+
+    EXPECT_CALL(h3, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+    EXPECT_CALL(h2, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+    EXPECT_CALL(h4, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+    EXPECT_CALL(h1, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+
+    EXPECT_CALL(h3, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+    EXPECT_CALL(h2, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+    EXPECT_CALL(h4, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+    EXPECT_CALL(h1, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+  }
+
+  sim.initialize();
+  sim.step();
+  sim.step();
+
+  EXPECT_CALL(h1, finalize(Ref(sim))).Times(1);
+  EXPECT_CALL(h2, finalize(Ref(sim))).Times(1);
+  EXPECT_CALL(h3, finalize(Ref(sim))).Times(1);
+  EXPECT_CALL(h4, finalize(Ref(sim))).Times(1);
+  sim.finalize();
+}
+
+TEST(testSimEngine, run)
+{
+  SimEngine sim{};
+  for(SimTime t = 1; t <= 10; ++t)
+  {
+    sim.insertEvent(t, 10);
+  }
+
+  EXPECT_THROW(sim.run(), std::runtime_error);
+  EXPECT_THROW(sim.runUntil(5), std::runtime_error);
+  EXPECT_THROW(sim.runFor(5), std::runtime_error);
+
+  MockHandler h1{};
+  sim.subscribe(&h1);
+  EXPECT_CALL(h1, initialize(Ref(sim))).Times(1);
+  sim.initialize();
+
+  // Run until processes all events at or before the stop time
+  EXPECT_CALL(h1, handleEvent(Ref(sim), ::testing::_)).Times(11);
+  EXPECT_EQ(4, sim.runUntil(4));
+  EXPECT_EQ(4, sim.time());
+  EXPECT_EQ(0, sim.runUntil(4));
+
+  // Run for processes up to the given number of events
+  std::vector<SimTime> observed{};
+  EXPECT_EQ(3, sim.runFor(3, [&observed] (SimEngine& s, const Event& evt) { observed.push_back(evt.time()); }));
+  EXPECT_EQ((std::vector<SimTime>{5, 6, 7}), observed);
+  EXPECT_EQ(0, sim.runFor(0));
+
+  EXPECT_THROW(sim.run(SimEngine::EventObserver{}), std::invalid_argument);
+
+  // Run processes events until the schedule is empty, including events inserted while running
+  sim.insertEvent(20, 10);
+  EXPECT_EQ(4, sim.run());
+  EXPECT_EQ(20, sim.time());
+  EXPECT_FALSE(sim.hasNextEvent());
+  EXPECT_EQ(0, sim.runFor(5));
+
+  // Causality violations are reported without leaving the Running state
+  sim.insertEvent(1, 10);
+  EXPECT_THROW(sim.run(), CausalityException);
+  EXPECT_EQ(SimEngineState::Running, sim.state());
+
+  EXPECT_CALL(h1, finalize(Ref(sim))).Times(1);
+  sim.finalize();
+}
+
+TEST(testSimEngine, step_batch)
+{
+  SimEngine sim{};
+  sim.insertEvent(1, 10, 1);
+  sim.insertEvent(1, 20, 2);
+  sim.insertEvent(1, 10, 3);
+  sim.insertEvent(1, 10, 4);
+  sim.insertEvent(2, 20, 5);
+
+  EXPECT_THROW(sim.stepBatch(), std::runtime_error);
+
+  BatchHandler batch{};
+  MockHandler single{};
+  sim.subscribe(&batch);
+  sim.subscribe(&single, 10);
+
+  EXPECT_CALL(single, initialize(Ref(sim))).Times(1);
+  sim.initialize();
+
+  // Spans follow the schedule order, handlers without handleEvents receive events one at a time
+  EXPECT_CALL(single, handleEvent(Ref(sim), ::testing::_)).Times(3);
+  EXPECT_EQ(4, sim.stepBatch());
+  EXPECT_EQ(1, sim.time());
+  EXPECT_EQ(1, sim.eventCount());
+
+  typedef std::tuple<SimTime, EventType, size_t> Batch;
+  EXPECT_EQ((std::vector<Batch>{Batch{1, 10, 1}, Batch{1, 20, 1}, Batch{1, 10, 2}}), batch.batches);
+  EXPECT_EQ((std::vector<EventTag>{1, 2, 3, 4}), batch.tags);
+
+  // Grouping by type gives one span per type, keeping the schedule order within each type
+  batch.batches.clear();
+  batch.tags.clear();
+  sim.insertEvent(2, 10, 6);
+  sim.insertEvent(2, 20, 7);
+  sim.insertEvent(2, 10, 8);
+  EXPECT_CALL(single, handleEvent(Ref(sim), ::testing::_)).Times(2);
+  EXPECT_EQ(4, sim.stepBatch(true));
+  EXPECT_EQ(2, sim.time());
+  EXPECT_FALSE(sim.hasNextEvent());
+
+  EXPECT_EQ((std::vector<Batch>{Batch{2, 10, 2}, Batch{2, 20, 2}}), batch.batches);
+  EXPECT_EQ((std::vector<EventTag>{6, 8, 5, 7}), batch.tags);
+
+  EXPECT_THROW(sim.stepBatch(), std::runtime_error);
+  EXPECT_EQ(SimEngineState::Running, sim.state());
+
+  // Causality violations are reported without leaving the Running state
+  sim.insertEvent(1, 10);
+  EXPECT_THROW(sim.stepBatch(), CausalityException);
+  EXPECT_EQ(SimEngineState::Running, sim.state());
+
+  EXPECT_CALL(single, finalize(Ref(sim))).Times(1);
+  sim.finalize();
+}
+
+TEST(testSimEngine, keyed_subscriptions)
+{
+  SimEngine sim{};
+
+  MockHandler global{};
+  MockHandler owner1{};
+  MockHandler owner2{};
+
+  EXPECT_THROW(sim.subscribe(nullptr, 10, 1), std::invalid_argument);
+
+  sim.subscribe(&global);
+  sim.subscribe(&owner1, 10, 1);
+  sim.subscribe(&owner2, 10, 2);
+  sim.subscribe(&owner2, 20, 1);
+  EXPECT_NO_THROW(sim.subscribe(&owner1, 10, 1));
+  EXPECT_THROW(sim.subscribe(&owner2, 10, 1), std::invalid_argument);
+
+  auto handlers = sim.getAllHandlers();
+  EXPECT_EQ(3, handlers.size());
+
+  EXPECT_CALL(global, initialize(Ref(sim))).Times(1);
+  EXPECT_CALL(owner1, initialize(Ref(sim))).Times(1);
+  EXPECT_CALL(owner2, initialize(Ref(sim))).Times(1);
+  sim.initialize();
+
+  // Events are routed to the owner of their type and tag only, after the global handlers
+  Event e1{1, 10, 1};
+  Event e2{2, 10, 2};
+  Event e3{3, 20, 1};
+  Event e4{4, 10, 3};
+  sim.insertEvent(e1);
+  sim.insertEvent(e2);
+  sim.insertEvent(e3);
+  sim.insertEvent(e4);
+
+  {
+    ::testing::InSequence seq{};
+    EXPECT_CALL(global, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+    EXPECT_CALL(owner1, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+    EXPECT_CALL(global, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+    EXPECT_CALL(owner2, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+    EXPECT_CALL(global, handleEvent(Ref(sim), EventEQ(e3))).Times(1);
+    EXPECT_CALL(owner2, handleEvent(Ref(sim), EventEQ(e3))).Times(1);
+    EXPECT_CALL(global, handleEvent(Ref(sim), EventEQ(e4))).Times(1);
+  }
+  EXPECT_EQ(4, sim.run());
+
+  // Keyed handlers receive runs of events with their tag in batch mode
+  sim.insertEvent(5, 10, 1);
+  sim.insertEvent(5, 10, 1);
+  sim.insertEvent(5, 10, 2);
+  EXPECT_CALL(global, handleEvent(Ref(sim), ::testing::_)).Times(3);
+  EXPECT_CALL(owner1, handleEvent(Ref(sim), ::testing::_)).Times(2);
+  EXPECT_CALL(owner2, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  EXPECT_EQ(3, sim.stepBatch());
+
+  // Subscribing to all events removes keyed subscriptions
+  sim.subscribe(&owner1);
+  sim.insertEvent(6, 10, 1);
+  EXPECT_CALL(global, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  EXPECT_CALL(owner1, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  EXPECT_NO_THROW(sim.subscribe(&owner2, 10, 1));
+  EXPECT_CALL(owner2, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  sim.step();
+
+  EXPECT_CALL(global, finalize(Ref(sim))).Times(1);
+  EXPECT_CALL(owner1, finalize(Ref(sim))).Times(1);
+  EXPECT_CALL(owner2, finalize(Ref(sim))).Times(1);
+  sim.finalize();
+}
+
+TEST(testSimEngine, keyed_and_type_subscriptions)
+{
+  SimEngine sim{};
+
+  MockHandler typed{};
+  MockHandler ranged{};
+  MockHandler owner{};
+
+  // Handlers owning a type and tag they also receive through a type, range or mask subscription
+  sim.subscribe(&typed, 10);
+  sim.subscribe(&typed, 10, 1);
+  sim.subscribeRange(&ranged, 2000, 2999);
+  sim.subscribe(&ranged, 2500, 1);
+  sim.subscribe(&owner, 10, 2);
+
+  EXPECT_CALL(typed, initialize(Ref(sim))).Times(1);
+  EXPECT_CALL(ranged, initialize(Ref(sim))).Times(1);
+  EXPECT_CALL(owner, initialize(Ref(sim))).Times(1);
+  sim.initialize();
+
+  Event e1{1, 10, 1};
+  Event e2{2, 10, 2};
+  Event e3{3, 2500, 1};
+  sim.insertEvent(e1);
+  sim.insertEvent(e2);
+  sim.insertEvent(e3);
+
+  // Each handler receives an event once
+  EXPECT_CALL(typed, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+  EXPECT_CALL(typed, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+  EXPECT_CALL(owner, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+  EXPECT_CALL(ranged, handleEvent(Ref(sim), EventEQ(e3))).Times(1);
+  EXPECT_EQ(3, sim.run());
+
+  // Also in batch mode
+  sim.insertEvent(4, 10, 1);
+  sim.insertEvent(4, 10, 1);
+  sim.insertEvent(4, 10, 2);
+  sim.insertEvent(4, 2500, 1);
+  EXPECT_CALL(typed, handleEvent(Ref(sim), ::testing::_)).Times(3);
+  EXPECT_CALL(owner, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  EXPECT_CALL(ranged, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  EXPECT_EQ(4, sim.stepBatch(true));
+
+  // The keyed subscription still routes the type and tag once the type subscription is removed
+  sim.unsubscribe(&typed, 10);
+  sim.insertEvent(5, 10, 1);
+  EXPECT_CALL(typed, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  sim.step();
+
+  // Type and filter subscriptions made after the keyed subscription are also delivered once
+  sim.subscribe(&owner, 10);
+  sim.subscribeMask(&typed, 0xF, 0xA);
+  sim.insertEvent(6, 10, 1);
+  sim.insertEvent(6, 10, 2);
+  EXPECT_CALL(typed, handleEvent(Ref(sim), ::testing::_)).Times(2);
+  EXPECT_CALL(owner, handleEvent(Ref(sim), ::testing::_)).Times(2);
+  EXPECT_EQ(2, sim.run());
+
+  EXPECT_CALL(typed, finalize(Ref(sim))).Times(1);
+  EXPECT_CALL(ranged, finalize(Ref(sim))).Times(1);
+  EXPECT_CALL(owner, finalize(Ref(sim))).Times(1);
+  sim.finalize();
+}
+
+TEST(testSimEngine, type_filters)
+{
+  SimEngine sim{};
+
+  MockHandler range{};
+  MockHandler mask{};
+  MockHandler typed{};
+
+  EXPECT_THROW(sim.subscribeRange(nullptr, 1, 2), std::invalid_argument);
+  EXPECT_THROW(sim.subscribeRange(&range, 2, 1), std::invalid_argument);
+  EXPECT_THROW(sim.subscribeMask(nullptr, 0xFF00, 0x0100), std::invalid_argument);
+  EXPECT_THROW(sim.subscribeMask(&mask, 0xFF00, 0x0110), std::invalid_argument);
+
+  // Overlapping subscriptions deliver each event once
+  sim.subscribeRange(&range, 10, 19);
+  sim.subscribeRange(&range, 15, 30);
+  sim.subscribe(&typed, 12);
+  sim.subscribeRange(&typed, 12, 12);
+  sim.subscribeMask(&mask, 0xFFFF0000, 0x00010000);
+
+  auto handlers = sim.getAllHandlers();
+  EXPECT_EQ(3, handlers.size());
+
+  EXPECT_CALL(range, initialize(Ref(sim))).Times(1);
+  EXPECT_CALL(mask, initialize(Ref(sim))).Times(1);
+  EXPECT_CALL(typed, initialize(Ref(sim))).Times(1);
+  sim.initialize();
+
+  Event e1{1, 12};
+  Event e2{2, 20};
+  Event e3{3, 31};
+  Event e4{4, 0x00010005};
+  Event e5{5, 0x00020005};
+  sim.insertEvent(e1);
+  sim.insertEvent(e2);
+  sim.insertEvent(e3);
+  sim.insertEvent(e4);
+  sim.insertEvent(e5);
+
+  {
+    // Handlers subscribed to the type itself come first
+    ::testing::InSequence seq{};
+    EXPECT_CALL(typed, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+    EXPECT_CALL(range, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+    EXPECT_CALL(range, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+    EXPECT_CALL(mask, handleEvent(Ref(sim), EventEQ(e4))).Times(1);
+  }
+  EXPECT_EQ(5, sim.run());
+
+  // Large types are resolved on first dispatch, and again after subscriptions change
+  sim.insertEvent(6, 0x00010005);
+  EXPECT_CALL(mask, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  sim.step();
+
+  sim.subscribe(&mask);
+  sim.insertEvent(7, 0x00020005);
+  EXPECT_CALL(mask, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  sim.step();
+
+  EXPECT_CALL(range, finalize(Ref(sim))).Times(1);
+  EXPECT_CALL(mask, finalize(Ref(sim))).Times(1);
+  EXPECT_CALL(typed, finalize(Ref(sim))).Times(1);
+  sim.finalize();
+}
+
+TEST(testSimEngine, targeted_events)
+{
+  SimEngine sim{};
+
+  MockHandler global{};
+  MockHandler typed{};
+  MockHandler target1{};
+  MockHandler target2{};
+
+  EXPECT_THROW(sim.registerTarget(nullptr), std::invalid_argument);
+  EXPECT_THROW(sim.insertTargetedEvent(nullptr, 1, 10), std::invalid_argument);
+
+  sim.subscribe(&global);
+  sim.subscribe(&typed, 10);
+
+  const HandlerId id1 = sim.registerTarget(&target1);
+  EXPECT_NE(Event::NoTarget, id1);
+  EXPECT_EQ(id1, sim.registerTarget(&target1));
+
+  auto handlers = sim.getAllHandlers();
+  EXPECT_EQ(3, handlers.size());
+
+  // Registered targets are initialized with the subscribed handlers
+  EXPECT_CALL(global, initialize(Ref(sim))).Times(1);
+  EXPECT_CALL(typed, initialize(Ref(sim))).Times(1);
+  EXPECT_CALL(target1, initialize(Ref(sim))).Times(1);
+  sim.initialize();
+
+  // Addressed events reach their target only
+  Event e1{1, 10, 0, 0, id1};
+  Event e2{2, 10};
+  sim.insertEvent(e1);
+  sim.insertEvent(e2);
+
+  // Targets registered while running are initialized when registered
+  EXPECT_CALL(target2, initialize(Ref(sim))).Times(1);
+  sim.insertTargetedEvent(&target2, 3, 10, 5);
+
+  {
+    ::testing::InSequence seq{};
+    EXPECT_CALL(target1, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+    EXPECT_CALL(global, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+    EXPECT_CALL(typed, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+    EXPECT_CALL(target2, handleEvent(Ref(sim), EventEQ(Event{3, 10, 5}))).Times(1);
+  }
+  EXPECT_EQ(3, sim.run());
+
+  // Batches split on target
+  sim.insertTargetedEvent(&target1, 4, 10);
+  sim.insertTargetedEvent(&target1, 4, 10);
+  sim.insertEvent(4, 10);
+  EXPECT_CALL(target1, handleEvent(Ref(sim), ::testing::_)).Times(2);
+  EXPECT_CALL(global, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  EXPECT_CALL(typed, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  EXPECT_EQ(3, sim.stepBatch());
+
+  // Events addressed to an unregistered id are an error
+  sim.insertEvent(Event{5, 10, 0, 0, 100});
+  EXPECT_THROW(sim.step(), std::runtime_error);
+  EXPECT_EQ(SimEngineState::Error, sim.state());
+}
+
+TEST(testSimEngine, dynamic_subscriptions)
+{
+  SimEngine sim{};
+
+  MockHandler joiner{};
+  MockHandler other{};
+
+  // Joins another handler and leaves on the first event it handles
+  int leaverCalls = 0;
+  CallbackHandler leaver{[&] (SimEngine& s, const Event& evt)
+  {
+    ++leaverCalls;
+    s.subscribe(&joiner, 10);
+    s.unsubscribe(&leaver);
+  }};
+
+  sim.subscribe(&leaver, 10);
+  sim.subscribe(&other, 10);
+  EXPECT_CALL(other, initialize(Ref(sim))).Times(1);
+  sim.initialize();
+
+  // Changes made while dispatching take effect after the event has reached all its handlers
+  Event e1{1, 10};
+  Event e2{2, 10};
+  sim.insertEvent(e1);
+  sim.insertEvent(e2);
+  {
+    ::testing::InSequence seq{};
+    EXPECT_CALL(other, handleEvent(Ref(sim), EventEQ(e1))).Times(1);
+    EXPECT_CALL(joiner, initialize(Ref(sim))).Times(1);
+    EXPECT_CALL(other, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+    EXPECT_CALL(joiner, handleEvent(Ref(sim), EventEQ(e2))).Times(1);
+  }
+  EXPECT_EQ(2, sim.run());
+  EXPECT_EQ(1, leaverCalls);
+
+  // Changes made between events take effect immediately
+  sim.subscribe(&other, 20);
+  sim.unsubscribe(&other, 10);
+  sim.insertEvent(3, 10);
+  sim.insertEvent(4, 20);
+  EXPECT_CALL(joiner, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  EXPECT_CALL(other, handleEvent(Ref(sim), ::testing::_)).Times(1);
+  EXPECT_EQ(2, sim.run());
+
+  // Unsubscribing a target discards events addressed to it
+  sim.insertTargetedEvent(&joiner, 5, 30);
+  EXPECT_CALL(joiner, finalize(Ref(sim))).Times(1);
+  sim.unsubscribe(&joiner);
+  EXPECT_EQ(1, sim.run());
+
+  EXPECT_THROW(sim.unsubscribe(nullptr), std::invalid_argument);
+  EXPECT_THROW(sim.unsubscribe(nullptr, 10), std::invalid_argument);
+
+  auto handlers = sim.getAllHandlers();
+  EXPECT_EQ(1, handlers.size());
+
+  EXPECT_CALL(other, finalize(Ref(sim))).Times(1);
+  sim.finalize();
+}
+
+TEST(testSimEngine, dynamic_subscriptions_churn)
+{
+  SimEngine sim{};
+
+  // Agents join and leave while running, each counting the events it receives
+  std::vector<int> counts(50, 0);
+  std::vector<std::unique_ptr<CallbackHandler>> agents{};
+  for(size_t i = 0; i < counts.size(); ++i)
+  {
+    agents.emplace_back(new CallbackHandler{[&counts, i] (SimEngine& s, const Event& evt) { ++counts[i]; }});
+  }
+
+  CallbackHandler driver{[&agents] (SimEngine& s, const Event& evt)
+  {
+    // Agent joins on an even tag and leaves on the following odd tag
+    CallbackHandler* agent = agents[evt.tag() / 2].get();
+    if((evt.tag() % 2) == 0)
+    {
+      s.subscribe(agent, 2);
+    }
+    else
+    {
+      s.unsubscribe(agent);
+    }
+  }};
+
+  sim.subscribe(&driver, 1);
+  sim.initialize();
+
+  for(EventTag i = 0; i < 100; ++i)
+  {
+    sim.insertEvent(2 * i, 1, i);
+    sim.insertEvent(2 * i + 1, 2);
+  }
+
+  EXPECT_EQ(200, sim.run());
+
+  // Each agent sees only the event between its join and leave
+  for(const auto& count : counts)
+  {
+    EXPECT_EQ(1, count);
+  }
+}
+
+TEST(testSimEngine, dynamic_lifecycle)
+{
+  SimEngine sim{};
+
+  LifecycleHandler early{};
+  LifecycleHandler late{};
+  LifecycleHandler ranged{};
+  LifecycleHandler target{};
+
+  // Joins a handler on tag 0 and removes one on tag 1
+  CallbackHandler driver{[&] (SimEngine& s, const Event& evt)
+  {
+    if(evt.tag() == 0)
+    {
+      s.subscribe(&late, 2);
+      EXPECT_EQ(0, late.initialized);
+    }
+    else
+    {
+      s.unsubscribe(&early);
+      EXPECT_EQ(0, early.finalized);
+    }
+  }};
+
+  sim.subscribe(&driver, 1);
+  sim.subscribe(&early, 2);
+  sim.initialize();
+  EXPECT_EQ(1, early.initialized);
+  EXPECT_EQ(0, late.initialized);
+
+  // Handlers changed from inside a handler are initialized and finalized once the event has reached all its handlers
+  sim.insertEvent(1, 1, 0);
+  sim.insertEvent(2, 2);
+  sim.insertEvent(3, 1, 1);
+  sim.insertEvent(4, 2);
+  EXPECT_EQ(4, sim.run());
+
+  EXPECT_EQ(1, late.initialized);
+  EXPECT_EQ(2, late.events);
+  EXPECT_EQ(1, early.finalized);
+  EXPECT_EQ(1, early.events);
+
+  // Handlers changed between events are initialized and finalized immediately, once however many subscriptions they have
+  sim.subscribeRange(&ranged, 2, 3);
+  sim.subscribe(&ranged, 4, 1);
+  EXPECT_EQ(1, ranged.initialized);
+  sim.insertTargetedEvent(&target, 5, 3);
+  EXPECT_EQ(1, target.initialized);
+  EXPECT_EQ(1, sim.run());
+
+  sim.unsubscribe(&ranged);
+  EXPECT_EQ(1, ranged.finalized);
+
+  // Removing the last type subscription leaves the simulation
+  sim.subscribe(&late, 3);
+  sim.unsubscribe(&late, 2);
+  EXPECT_EQ(0, late.finalized);
+  sim.unsubscribe(&late, 3);
+  EXPECT_EQ(1, late.finalized);
+
+  // A handler that left joins again as a new handler
+  sim.subscribe(&early);
+  EXPECT_EQ(2, early.initialized);
+
+  sim.finalize();
+  EXPECT_EQ(2, early.finalized);
+  EXPECT_EQ(1, late.finalized);
+  EXPECT_EQ(1, ranged.finalized);
+  EXPECT_EQ(1, target.finalized);
+  EXPECT_EQ(1, target.events);
+
+  auto handlers = sim.getAllHandlers();
+  EXPECT_EQ(3, handlers.size());
+}
+
+TEST(testSimEngine, dynamic_targets_and_keys)
+{
+  SimEngine sim{};
+
+  LifecycleHandler target{};
+  LifecycleHandler first{};
+  LifecycleHandler second{};
+
+  // Addresses an event to a new handler, then two handlers try to take the same type and tag
+  bool conflict = false;
+  CallbackHandler driver{[&] (SimEngine& s, const Event& evt)
+  {
+    s.insertTargetedEvent(&target, evt.time() + 1, 2);
+    EXPECT_EQ(0, target.initialized);
+
+    s.subscribe(&first, 3, 7);
+    try
+    {
+      s.subscribe(&second, 3, 7);
+    }
+    catch(const std::invalid_argument&)
+    {
+      conflict = true;
+    }
+  }};
+
+  sim.subscribe(&driver, 1);
+  sim.initialize();
+
+  // Targets registered while dispatching are initialized once the event has reached all its handlers
+  sim.insertEvent(1, 1);
+  EXPECT_NO_THROW(sim.step());
+  EXPECT_EQ(1, target.initialized);
+  EXPECT_EQ(SimEngineState::Running, sim.state());
+
+  // Conflicting keyed subscriptions queued in one dispatch are reported to the caller
+  EXPECT_TRUE(conflict);
+  EXPECT_EQ(1, first.initialized);
+  EXPECT_EQ(0, second.initialized);
+
+  sim.insertEvent(3, 3, 7);
+  EXPECT_EQ(2, sim.run());
+  EXPECT_EQ(1, target.events);
+  EXPECT_EQ(1, first.events);
+  EXPECT_EQ(0, second.events);
+
+  sim.finalize();
+  EXPECT_EQ(1, target.finalized);
+  EXPECT_EQ(1, first.finalized);
+}
@@ -0,0 +1,27 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/SortedArrayBackend.h"
+
+using namespace des;
+
+TEST(testSortedArrayBackend, bulk)
+{
+  SortedArrayBackend q{};
+  q.insert(Event{5, 1});
+  q.insert(Event{1, 2});
+
+  // Appended events are sorted and merged with the held events
+  q.reserve(5);
+  const Event appended[] = {Event{3, 3}, Event{5, 4}, Event{0, 5}};
+  for(size_t i = 0; i < 3; ++i)
+  {
+    q.appendUnordered(appended[i], EventKey::Make(appended[i], 2 + i));
+  }
+  q.restoreOrder(3);
+  ASSERT_EQ(5, q.size());
+
+  for(EventType type : {5, 2, 3, 1, 4})
+  {
+    EXPECT_EQ(type, q.getNext().type());
+  }
+}
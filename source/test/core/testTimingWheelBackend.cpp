@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+#include "core/Event.h"
+#include "core/TimingWheelBackend.h"
+
+using namespace des;
+
+TEST(testTimingWheelBackend, ctor)
+{
+  TimingWheelBackend q{};
+
+  EXPECT_EQ(0, q.size());
+}
+
+TEST(testTimingWheelBackend, cascade)
+{
+  TimingWheelBackend q{};
+
+  q.insert(Event{UINT64_MAX, 1});
+  q.insert(Event{0x10000, 2});
+  q.insert(Event{0x100FF, 3});
+  q.insert(Event{0xFF, 4});
+  q.insert(Event{0, 5});
+
+  EXPECT_EQ(5, q.getNext().type());
+  EXPECT_EQ(4, q.getNext().type());
+  EXPECT_EQ(2, q.getNext().type());
+
+  // Near event inserted after cascading
+  q.insert(Event{0x10001, 6});
+  EXPECT_EQ(6, q.getNext().type());
+  EXPECT_EQ(3, q.getNext().type());
+  EXPECT_EQ(1, q.getNext().type());
+  EXPECT_EQ(0, q.size());
+}
+
+TEST(testTimingWheelBackend, early)
+{
+  TimingWheelBackend q{};
+
+  q.insert(Event{10, 1});
+  q.insert(Event{20, 2});
+  EXPECT_EQ(10, q.getNext().time());
+
+  // Peeking moves the wheel up to the next event
+  EXPECT_EQ(20, q.peekNext().time());
+
+  // Events before the wheel time are returned first
+  q.insert(Event{15, 3});
+  q.insert(Event{5, 4});
+  EXPECT_EQ(3, q.size());
+
+  EXPECT_EQ(5, q.getNext().time());
+  EXPECT_EQ(15, q.getNext().time());
+  EXPECT_EQ(20, q.getNext().time());
+  EXPECT_EQ(0, q.size());
+}
@@ -206,3 +206,52 @@ TEST(testBinaryEventReader, readMultiple)
   EXPECT_FALSE(str.good());
   EXPECT_TRUE(str.eof());
 }
+
+TEST(testBinaryEventReader, read_priorityTarget)
+{
+  std::stringstream str{std::ios_base::in | std::ios_base::out | std::ios_base::binary};
+  BinaryEventReader reader{str, BinaryEventFormat::V2};
+  EXPECT_EQ(BinaryEventFormat::V2, reader.format());
+
+  char buffer[BUFF_SIZE];
+  char* pBuffer = buffer;
+
+  // Fill buffer with V2 event data
+  *(SimTime*)pBuffer = 12;
+  pBuffer += sizeof(SimTime);
+  *(EventType*)pBuffer = 34;
+  pBuffer += sizeof(EventType);
+  *(EventTag*)pBuffer = 56;
+  pBuffer += sizeof(EventTag);
+  *(EventPriority*)pBuffer = 7;
+  pBuffer += sizeof(EventPriority);
+  *(HandlerId*)pBuffer = 89;
+  pBuffer += sizeof(HandlerId);
+
+  // Write buffer to stream
+  str.write(buffer, BinaryEventSize(BinaryEventFormat::V2));
+  EXPECT_TRUE(str.good());
+
+  try
+  {
+    // Read event (should not throw)
+    Event evt = reader.read();
+    EXPECT_TRUE(reader.stream().good());
+
+    // Check event
+    EXPECT_EQ(12, evt.time());
+    EXPECT_EQ(34, evt.type());
+    EXPECT_EQ(56, evt.tag());
+    EXPECT_EQ(7, evt.priority());
+    EXPECT_EQ(89, evt.target());
+  }
+  catch(EventReadException& ex)
+  {
+    FAIL() << "EventReadException:  " << ex.what();
+  }
+
+  // Check for EOF
+  str.read(buffer, 1);
+  EXPECT_FALSE(str.good());
+  EXPECT_TRUE(str.eof());
+}
@@ -90,3 +90,47 @@ TEST(testBinaryEventWriter, write_streamCtor)
   EXPECT_FALSE(str.good());
   EXPECT_TRUE(str.eof());
 }
+
+TEST(testBinaryEventWriter, write_priorityTarget)
+{
+  std::stringstream str{std::ios_base::in | std::ios_base::out | std::ios_base::binary};
+
+  char buffer[BUFF_SIZE];
+  char* pBuffer = buffer;
+
+  Event e{12, 34, 56, 7, 89};
+
+  // V1 layout can't hold priority or target (should throw without writing)
+  {
+    BinaryEventWriter writer{str};
+    EXPECT_EQ(BinaryEventFormat::V1, writer.format());
+    ASSERT_THROW(writer.write(e), EventWriteException);
+    ASSERT_THROW(writer.write(Event{12, 34, 56, 7}), EventWriteException);
+    ASSERT_THROW(writer.write(Event{12, 34, 56, 0, 89}), EventWriteException);
+    EXPECT_TRUE(writer.stream().good());
+    EXPECT_EQ(0, str.tellp());
+  }
+
+  // V2 layout carries both
+  BinaryEventWriter writer{str, BinaryEventFormat::V2};
+  ASSERT_NO_THROW(writer.write(e));
+  EXPECT_TRUE(writer.stream().good());
+
+  str.read(buffer, BinaryEventSize(BinaryEventFormat::V2));
+  EXPECT_TRUE(str.good());
+
+  EXPECT_EQ(e.time(), *(SimTime*)pBuffer);
+  pBuffer += sizeof(SimTime);
+  EXPECT_EQ(e.type(), *(EventType*)pBuffer);
+  pBuffer += sizeof(EventType);
+  EXPECT_EQ(e.tag(), *(EventTag*)pBuffer);
+  pBuffer += sizeof(EventTag);
+  EXPECT_EQ(e.priority(), *(EventPriority*)pBuffer);
+  pBuffer += sizeof(EventPriority);
+  EXPECT_EQ(e.target(), *(HandlerId*)pBuffer);
+
+  // Check for EOF
+  str.read(buffer, 1);
+  EXPECT_FALSE(str.good());
+  EXPECT_TRUE(str.eof());
+}
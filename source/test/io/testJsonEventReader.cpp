@@ -286,3 +286,43 @@ TEST(testJsonEventReader, readMultiple)
   EXPECT_FALSE(str.good());
   EXPECT_TRUE(str.eof());
 }
+
+TEST(testJsonEventReader, read_priority)
+{
+  std::stringstream str{std::ios_base::in | std::ios_base::out};
+  JsonEventReader reader{str.rdbuf()};
+
+  // Create JSON strings, the second without a priority
+  std::stringstream stringBuilder{};
+  stringBuilder << "{";
+  stringBuilder << "\"time\":" << (SimTime)12;
+  stringBuilder << ",\"type\":" << (EventType)34;
+  stringBuilder << ",\"tag\":" << (EventTag)56;
+  stringBuilder << ",\"priority\":" << (EventPriority)78;
+  stringBuilder << "}";
+  stringBuilder << "{";
+  stringBuilder << "\"time\":" << (SimTime)12;
+  stringBuilder << ",\"type\":" << (EventType)34;
+  stringBuilder << ",\"tag\":" << (EventTag)56;
+  stringBuilder << "}";
+  const std::string json{stringBuilder.str()};
+
+  // Write JSON to stream
+  str << json;
+  EXPECT_TRUE(str.good());
+
+  try
+  {
+    Event evt1 = reader.read();
+    EXPECT_EQ(12, evt1.time());
+    EXPECT_EQ(78, evt1.priority());
+
+    Event evt2 = reader.read();
+    EXPECT_EQ(12, evt2.time());
+    EXPECT_EQ(0, evt2.priority());
+  }
+  catch(EventReadException& ex)
+  {
+    FAIL() << "EventReadException:  " << ex.what();
+  }
+}
@@ -102,3 +102,21 @@ TEST(testJsonEventWriter, write_streamCtor)
   EXPECT_FALSE(str.good());
   EXPECT_TRUE(str.eof());
 }
+
+TEST(testJsonEventWriter, write_priority)
+{
+  std::stringstream str{std::ios_base::in | std::ios_base::out};
+  JsonEventWriter writer{str};
+
+  // Priority is only written when set
+  ASSERT_NO_THROW(writer.write(Event{12, 34, 56, 78}));
+  ASSERT_NO_THROW(writer.write(Event{12, 34, 56}));
+
+  nlohmann::json obj{};
+  str >> obj;
+  ASSERT_TRUE(obj.find("priority") != obj.end());
+  EXPECT_EQ(78, obj["priority"]);
+
+  str >> obj;
+  EXPECT_TRUE(obj.find("priority") == obj.end());
+}